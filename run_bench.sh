@@ -0,0 +1,154 @@
+#!/bin/bash
+
+# Uso: ./run_bench.sh [-t segundos] [-b baseline.csv] [--save-baseline] [-d carpeta] <dpllSolver>
+#
+# Resuelve cada familia de instancias (cada subcarpeta de tests/dpll) de a una instancia por
+# proceso, con un tiempo límite por instancia, y muestra por familia:
+#   - resueltas, fuera de tiempo y respuestas incorrectas (los archivos uf* son satisfacibles
+#     y los uuf* insatisfacibles),
+#   - PAR-2: el tiempo promedio por instancia, contando como 2 * límite las que no se resolvieron,
+#   - la mediana y el percentil 95 de esos mismos tiempos,
+#   - las propagaciones por segundo (todas las propagaciones entre todo el tiempo).
+# Si existe el archivo base (baseline) se compara cada familia contra él y se marcan como
+# REGRESSION los cambios de más de un 10% a peor (en los tiempos, solo si además empeoran en
+# más de 10 ms, porque en las familias fáciles cualquier ruido es más del 10%). Con --save-baseline el resumen se guarda
+# como nuevo archivo base.
+#
+# Termina con 1 si alguna respuesta es incorrecta y con 2 si hay regresiones.
+
+time_limit=60
+baseline=tests/dpll/baseline.csv
+save_baseline=0
+tests_folder=tests/dpll
+solver=
+threshold=10
+noise_seconds=0.01
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -t) time_limit=$2; shift 2 ;;
+        -b) baseline=$2; shift 2 ;;
+        -d) tests_folder=$2; shift 2 ;;
+        --save-baseline) save_baseline=1; shift ;;
+        *) solver=$1; shift ;;
+    esac
+done
+
+if [ -z "$solver" ] || [ ! -x "$solver" ]; then
+    echo "Uso: $0 [-t segundos] [-b baseline.csv] [--save-baseline] [-d carpeta] <dpllSolver>"
+    exit 1
+fi
+
+backstop=$(awk -v limit="$time_limit" 'BEGIN { print limit + 5 }')
+
+output_folder=$(dirname "$solver")
+results="$output_folder/bench_results.csv"
+summary="$output_folder/bench_summary.csv"
+json="$output_folder/bench_instance.json"
+
+echo "family,instance,expected,status,seconds,propagations" > "$results"
+
+for family_path in "$tests_folder"/*/; do
+    family=$(basename "$family_path")
+    if ! ls "$family_path"*.cnf > /dev/null 2>&1; then
+        continue
+    fi
+    echo "Resolviendo $family..."
+
+    for instance in "$family_path"*.cnf; do
+        name=$(basename "$instance")
+        case "$name" in
+            uuf*) expected=UNSAT ;;
+            uf*) expected=SAT ;;
+            *) expected=UNKNOWN ;;
+        esac
+
+        # El solver se detiene solo con --time-limit (UNKNOWN) y aun escribe sus estadisticas;
+        # timeout queda de respaldo (con SIGINT tambien las escribe, -k por si no responde)
+        rm -f "$json"
+        timeout -s INT -k 5 "$backstop" "$solver" --time-limit "$time_limit" --stats-json "$json" "$instance" > /dev/null 2>&1
+
+        if [ -s "$json" ]; then
+            status=$(grep -o '"status":"[A-Z]*"' "$json" | cut -d'"' -f4)
+            seconds=$(grep -o '"seconds":[0-9.e+-]*' "$json" | head -1 | cut -d: -f2)
+            propagations=$(grep -o '"propagations":[0-9]*' "$json" | cut -d: -f2)
+        else
+            # El proceso no termino bien (o hubo que matarlo)
+            status=ERROR
+            seconds=$time_limit
+            propagations=0
+        fi
+        echo "$family,$name,$expected,$status,$seconds,$propagations" >> "$results"
+    done
+done
+
+# Resumen por familia. Las que no se resolvieron tardaron al menos el limite, asi que ordenar por
+# tiempo tambien deja ordenados los tiempos con penalizacion (para la mediana y el percentil 95)
+tail -n +2 "$results" | sort -t, -k1,1 -k5,5g | awk -F, -v limit="$time_limit" '
+    function report() {
+        if (n == 0) return
+        median = (n % 2 == 1) ? times[(n + 1) / 2] : (times[n / 2] + times[n / 2 + 1]) / 2
+        p95 = times[int(0.95 * n + 0.999999)]
+        printf "%s,%d,%d,%d,%d,%.6f,%.6f,%.6f,%.0f\n", family, n, solved, timeouts, wrong,
+               par2 / n, median, p95, (seconds > 0 ? propagations / seconds : 0)
+    }
+    BEGIN { print "family,instances,solved,timeouts,wrong,par2,median,p95,propagations_per_second" }
+    $1 != family { report(); family = $1; n = solved = timeouts = wrong = par2 = seconds = propagations = 0 }
+    {
+        time = $5
+        if ($4 == "SAT" || $4 == "UNSAT") {
+            ++solved
+            if ($3 != "UNKNOWN" && $3 != $4) ++wrong
+        } else {
+            ++timeouts
+            time = 2 * limit
+        }
+        times[++n] = time
+        par2 += time
+        seconds += $5
+        propagations += $6
+    }
+    END { report() }' > "$summary"
+rm -f "$json"
+
+echo
+awk -F, '{ printf "%-12s %10s %7s %9s %6s %12s %12s %12s %24s\n", $1, $2, $3, $4, $5, $6, $7, $8, $9 }' "$summary"
+
+exit_code=0
+if awk -F, 'NR > 1 && $5 > 0 { found = 1 } END { exit !found }' "$summary"; then
+    echo
+    echo "ERROR: hay respuestas incorrectas, ver $results"
+    exit_code=1
+fi
+
+if [ -f "$baseline" ] && [ "$save_baseline" -eq 0 ]; then
+    echo
+    echo "Comparación con $baseline (cambio porcentual; en PAR-2, mediana y p95 menos es mejor):"
+    awk -F, -v threshold="$threshold" -v noise="$noise_seconds" '
+        function change(new, old) { return old > 0 ? 100 * (new - old) / old : 0 }
+        function slower(new, old) { return new - old > noise && change(new, old) > threshold }
+        NR == FNR { if (FNR > 1) { base_par2[$1] = $6; base_median[$1] = $7; base_p95[$1] = $8; base_rate[$1] = $9 } next }
+        FNR == 1 { printf "%-12s %10s %10s %10s %14s\n", "family", "par2", "median", "p95", "propagations/s"; next }
+        !($1 in base_par2) { printf "%-12s (sin base)\n", $1; next }
+        {
+            par2 = change($6, base_par2[$1]); median = change($7, base_median[$1])
+            p95 = change($8, base_p95[$1]); rate = change($9, base_rate[$1])
+            flag = (slower($6, base_par2[$1]) || slower($7, base_median[$1]) || slower($8, base_p95[$1]) ||
+                    rate < -threshold) ? "  REGRESSION" : ""
+            if (flag != "") regressions = 1
+            printf "%-12s %+9.1f%% %+9.1f%% %+9.1f%% %+13.1f%%%s\n", $1, par2, median, p95, rate, flag
+        }
+        END { exit regressions ? 2 : 0 }' "$baseline" "$summary"
+    comparison=$?
+    if [ $comparison -ne 0 ] && [ $exit_code -eq 0 ]; then
+        exit_code=$comparison
+    fi
+fi
+
+if [ "$save_baseline" -eq 1 ]; then
+    cp "$summary" "$baseline"
+    echo
+    echo "Resumen guardado como base en $baseline"
+fi
+
+exit $exit_code
@@ -1,7 +1,11 @@
 #!/bin/bash
 
-# Pedir al usuario la ruta de la carpeta
-read -p "Introduce la dirección de la carpeta: " folder_path
+# Uso: ./run_dpplsolver.sh [carpeta] [hilos]
+# Si no se indica la carpeta se le pide al usuario
+folder_path=$1
+if [ -z "$folder_path" ]; then
+    read -p "Introduce la dirección de la carpeta: " folder_path
+fi
 
 # Verificar si la carpeta existe
 if [ ! -d "$folder_path" ]; then
@@ -9,14 +13,12 @@ if [ ! -d "$folder_path" ]; then
     exit 1
 fi
 
-# Iterar sobre los archivos .cnf en la carpeta
-for file in "$folder_path"/*.cnf; do
-    # Verificar si hay archivos .cnf en la carpeta
-    if [ ! -e "$file" ]; then
-        echo "No se encontraron archivos .cnf en la carpeta."
-        exit 1
-    fi
+# Verificar si hay archivos .cnf en la carpeta
+if ! ls "$folder_path"/*.cnf > /dev/null 2>&1; then
+    echo "No se encontraron archivos .cnf en la carpeta."
+    exit 1
+fi
 
-    echo "Procesando $file..."
-    ./dpllSolver "$file"
-done
\ No newline at end of file
+# Resolver todos los .cnf en un solo proceso, repartidos entre varios hilos
+threads=${2:-$(nproc)}
+./dpllSolver --batch "$folder_path" -j "$threads"
@@ -0,0 +1,50 @@
+#include "allocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+/*
+ * Reemplazo de los operator new/delete globales que cuenta las reservas de memoria.
+ * El contador es propio de cada hilo, de modo que cada uno mide solo sus reservas.
+ */
+
+static thread_local uint64_t allocations = 0;
+
+uint64_t allocation_count()
+{
+	return allocations;
+}
+
+void *operator new(std::size_t size)
+{
+	++allocations;
+	if (void *pointer = std::malloc(size == 0 ? 1 : size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
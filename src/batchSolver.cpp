@@ -0,0 +1,196 @@
+#include "batchSolver.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Indica si `text` termina con `suffix`.
+ */
+static bool ends_with(const std::string &text, const std::string &suffix)
+{
+	return text.size() >= suffix.size() and text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::vector<std::string> collect_batch_instances(const std::string &path)
+{
+	std::vector<std::string> instances;
+
+	if (std::filesystem::is_directory(path))
+	{
+		for (const auto &entry : std::filesystem::directory_iterator(path))
+		{
+			std::string name = entry.path().filename().string();
+			if (entry.is_regular_file() and (ends_with(name, ".cnf") or ends_with(name, ".cnf.gz") or ends_with(name, ".cnf.xz")))
+			{
+				instances.push_back(entry.path().string());
+			}
+		}
+		std::sort(instances.begin(), instances.end());
+		return instances;
+	}
+
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Error: No se puede abrir la carpeta o la lista: " + path);
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (not line.empty() and line.back() == '\r')
+		{
+			line.pop_back();
+		}
+		if (not line.empty() and line[0] != '#')
+		{
+			instances.push_back(line);
+		}
+	}
+	return instances;
+}
+
+/**
+ * @brief Escribe una cadena como literal de JSON, escapando comillas y barras invertidas.
+ */
+static void write_json_string(const std::string &text, std::ostream &out)
+{
+	out << '"';
+	for (char c : text)
+	{
+		if (c == '"' or c == '\\')
+		{
+			out << '\\';
+		}
+		out << c;
+	}
+	out << '"';
+}
+
+/**
+ * @brief Escribe un campo de CSV, entre comillas (y duplicándolas) si tiene comas, comillas o
+ *        saltos de línea.
+ */
+static void write_csv_field(const std::string &text, std::ostream &out)
+{
+	if (text.find_first_of(",\"\n\r") == std::string::npos)
+	{
+		out << text;
+		return;
+	}
+	out << '"';
+	for (char c : text)
+	{
+		if (c == '"')
+		{
+			out << '"';
+		}
+		out << c;
+	}
+	out << '"';
+}
+
+/**
+ * @brief Escribe el resultado de una instancia en una sola línea con el formato pedido.
+ */
+static void write_batch_result(const BatchResult &result, int format, std::ostream &out)
+{
+	if (format == BATCH_FORMAT_JSON)
+	{
+		out << "{\"instance\":";
+		write_json_string(result.instance, out);
+		out << ",\"status\":\"" << result.status << "\""
+			<< ",\"seconds\":" << result.seconds
+			<< ",\"decisions\":" << result.statistics.decisions
+			<< ",\"propagations\":" << result.statistics.propagations
+			<< ",\"conflicts\":" << result.statistics.conflicts
+			<< ",\"restarts\":" << result.statistics.restarts;
+		if (not result.error.empty())
+		{
+			out << ",\"error\":";
+			write_json_string(result.error, out);
+		}
+		out << "}" << std::endl;
+	}
+	else
+	{
+		out << result.instance << "," << result.status << "," << result.seconds << ","
+			<< result.statistics.decisions << "," << result.statistics.propagations << ","
+			<< result.statistics.conflicts << "," << result.statistics.restarts << ",";
+		write_csv_field(result.error, out);
+		out << std::endl;
+	}
+}
+
+/**
+ * @brief Resuelve una instancia con un `Solver` propio y mide el tiempo que tarda.
+ */
+static BatchResult solve_batch_instance(const std::string &instance, const SolverOptions &options)
+{
+	BatchResult result;
+	result.instance = instance;
+
+	auto start_time = std::chrono::steady_clock::now();
+	try
+	{
+		Solver solver(options);
+		ParseStatistics parse_statistics = parse_DIMACS_input(instance, solver);
+		solver.solve();
+		result.status = result_name(solver.get_result());
+		result.statistics = solver.get_statistics();
+		result.statistics.parse = parse_statistics;
+	}
+	catch (const std::exception &e)
+	{
+		result.status = "ERROR";
+		result.error = e.what();
+	}
+	std::chrono::duration<double> elapsed_time = std::chrono::steady_clock::now() - start_time;
+	result.seconds = elapsed_time.count();
+
+	return result;
+}
+
+std::vector<BatchResult> solve_batch(const std::vector<std::string> &instances, uint num_threads, int format,
+									 const SolverOptions &options, std::ostream &out)
+{
+	std::vector<BatchResult> results(instances.size());
+
+	// La cola de trabajo es el indice de la siguiente instancia sin tomar
+	std::atomic<size_t> next_instance(0);
+	std::mutex out_mutex;
+
+	if (format == BATCH_FORMAT_CSV)
+	{
+		out << "instance,status,seconds,decisions,propagations,conflicts,restarts,error" << std::endl;
+	}
+
+	auto worker = [&]()
+	{
+		size_t i;
+		while ((i = next_instance.fetch_add(1)) < instances.size())
+		{
+			results[i] = solve_batch_instance(instances[i], options);
+
+			std::lock_guard<std::mutex> lock(out_mutex);
+			write_batch_result(results[i], format, out);
+		}
+	};
+
+	num_threads = std::max(1u, std::min<uint>(num_threads, instances.size()));
+	std::vector<std::thread> workers;
+	for (uint t = 1; t < num_threads; ++t)
+	{
+		workers.emplace_back(worker);
+	}
+	// El hilo principal tambien trabaja
+	worker();
+	for (std::thread &thread : workers)
+	{
+		thread.join();
+	}
+
+	return results;
+}
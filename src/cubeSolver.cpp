@@ -0,0 +1,389 @@
+#include "cubeSolver.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * Cuánto espera un hilo sin trabajo antes de volver a buscar cubos, en milisegundos.
+ */
+#define IDLE_WAIT_MS 1
+
+/**
+ * Un cubo: los literales de una asignación parcial.
+ */
+typedef std::vector<int> Cube;
+
+/**
+ * @brief La cola de cubos de un hilo y las banderas con las que los demás hilos se comunican con él.
+ */
+struct CubeWorker
+{
+	std::mutex mutex;
+
+	std::deque<Cube> cubes;
+
+	/**
+	 * Es la bandera de parada del solver del hilo: otro hilo la activa para pedirle que divida
+	 * su cubo, y también se activa cuando la búsqueda terminó.
+	 */
+	std::atomic<bool> split_request{false};
+
+	std::atomic<bool> busy{false};
+
+	/**
+	 * El cubo del hilo ya lleva `MIN_SPLIT_CONFLICTS` conflictos y se le puede pedir que lo divida.
+	 */
+	std::atomic<bool> splittable{false};
+};
+
+/**
+ * @brief Elige la variable con la que dividir un cubo, con una copia del solver base.
+ *
+ * @return La variable, o 0 si el cubo no se puede dividir.
+ */
+static int choose_cube_variable(const Solver &base, const Cube &cube)
+{
+	Solver scratch = base;
+	for (int literal : cube)
+	{
+		scratch.add_clause(&literal, 1);
+	}
+	return scratch.choose_lookahead_variable();
+}
+
+/**
+ * @brief Suma a `total` los contadores de la búsqueda de `statistics` (del nivel de decisión
+ *        máximo se queda con el mayor).
+ */
+static void add_statistics(SolverStatistics &total, const SolverStatistics &statistics)
+{
+	total.decisions += statistics.decisions;
+	total.propagations += statistics.propagations;
+	total.conflicts += statistics.conflicts;
+	total.learned_clauses += statistics.learned_clauses;
+	total.restarts += statistics.restarts;
+	total.max_decision_level = std::max(total.max_decision_level, statistics.max_decision_level);
+	total.conflict_level_sum += statistics.conflict_level_sum;
+	total.deleted_clauses += statistics.deleted_clauses;
+	total.reductions += statistics.reductions;
+	total.arena_compactions += statistics.arena_compactions;
+	total.propagation_allocations += statistics.propagation_allocations;
+}
+
+/**
+ * @brief Genera los cubos iniciales dividiendo siempre el cubo más corto, hasta tener `target`
+ *        cubos o hasta que ninguno se pueda dividir.
+ */
+static std::vector<Cube> generate_cubes(const Solver &base, size_t target)
+{
+	std::deque<Cube> pending(1);
+	std::vector<Cube> leaves;
+	while (not pending.empty() and pending.size() + leaves.size() < target)
+	{
+		Cube cube = pending.front();
+		pending.pop_front();
+
+		int var = choose_cube_variable(base, cube);
+		if (var == 0)
+		{
+			leaves.push_back(cube);
+			continue;
+		}
+
+		Cube positive = cube;
+		positive.push_back(var);
+		cube.push_back(-var);
+		pending.push_back(positive);
+		pending.push_back(cube);
+	}
+	leaves.insert(leaves.end(), pending.begin(), pending.end());
+	return leaves;
+}
+
+CubeResult solve_cubes(const std::string &dimacs_file_path, uint num_workers, const SolverOptions &options,
+					   const std::atomic<bool> *interrupt)
+{
+	num_workers = std::max(1u, num_workers);
+
+	CnfFormula formula;
+	ParseStatistics parse_statistics = parse_DIMACS_file(dimacs_file_path, formula);
+	Solver base(options);
+	base.add_formula(formula);
+
+	// Se preprocesa una sola vez, antes de elegir los cubos: asi los cubos y las divisiones solo usan
+	// variables que no se eliminaron, y las copias del solver base no vuelven a preprocesar
+	base.simplify_formula();
+
+	CubeResult result;
+	result.statistics.parse = parse_statistics;
+	result.statistics.preprocess = base.get_statistics().preprocess;
+
+	std::vector<Cube> initial_cubes = generate_cubes(base, num_workers * CUBES_PER_WORKER);
+	result.initial_cubes = initial_cubes.size();
+
+	std::vector<std::unique_ptr<CubeWorker>> workers;
+	for (uint id = 0; id < num_workers; ++id)
+	{
+		workers.emplace_back(new CubeWorker());
+	}
+	for (size_t k = 0; k < initial_cubes.size(); ++k)
+	{
+		workers[k % num_workers]->cubes.push_back(initial_cubes[k]);
+	}
+
+	// Cubos que todavia no se refutaron (en las colas o resolviendose)
+	std::atomic<uint64_t> outstanding(initial_cubes.size());
+	std::atomic<uint64_t> dynamic_splits(0);
+	std::atomic<uint64_t> refuted_cubes(0);
+	std::atomic<bool> finished(false);
+	std::atomic<uint> finished_workers(0);
+	std::mutex result_mutex;
+	std::exception_ptr worker_error;
+
+	// Lo que queda de los limites de `options` (al menos una unidad, porque 0 es sin limite)
+	auto start_time = std::chrono::steady_clock::now();
+	std::atomic<uint64_t> used_conflicts(0);
+	std::atomic<uint64_t> used_propagations(0);
+	auto remaining = [](uint64_t limit, uint64_t used)
+	{
+		return limit == 0 ? 0 : std::max<uint64_t>(limit - std::min(limit, used), 1);
+	};
+	auto remaining_time = [&]()
+	{
+		if (options.time_limit <= 0)
+		{
+			return 0.0;
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+		return std::max(options.time_limit - elapsed.count(), 1e-6);
+	};
+
+	auto finish = [&]()
+	{
+		finished.store(true);
+		for (auto &worker : workers)
+		{
+			worker->split_request.store(true);
+		}
+	};
+
+	// Primero el ultimo cubo propio (el mas profundo), si no el mas antiguo de otro hilo
+	auto take_cube = [&](uint id, Cube &cube)
+	{
+		for (uint k = 0; k < num_workers; ++k)
+		{
+			CubeWorker &worker = *workers[(id + k) % num_workers];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			if (worker.cubes.empty())
+			{
+				continue;
+			}
+			if (k == 0)
+			{
+				cube = std::move(worker.cubes.back());
+				worker.cubes.pop_back();
+			}
+			else
+			{
+				cube = std::move(worker.cubes.front());
+				worker.cubes.pop_front();
+			}
+			return true;
+		}
+		return false;
+	};
+
+	auto run_worker = [&](uint id)
+	{
+		CubeWorker &self = *workers[id];
+		try
+		{
+			Cube cube;
+			while (not finished.load())
+			{
+				if (not take_cube(id, cube))
+				{
+					// Sin trabajo: le pedimos a un hilo ocupado que divida su cubo
+					for (uint k = 1; k < num_workers; ++k)
+					{
+						CubeWorker &other = *workers[(id + k) % num_workers];
+						if (other.busy.load() and other.splittable.load() and not other.split_request.exchange(true))
+						{
+							break;
+						}
+					}
+					std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_WAIT_MS));
+					continue;
+				}
+
+				// Un solver por cubo tomado: al dividirlo, la mitad que se queda el hilo es el mismo cubo con
+				// un literal mas, asi que se le agrega ese literal y se conserva todo lo aprendido
+				self.busy.store(true);
+				Solver solver = base;
+				solver.set_stop_flag(&self.split_request);
+				for (int literal : cube)
+				{
+					solver.add_clause(&literal, 1);
+				}
+				uint64_t counted_conflicts = solver.get_statistics().conflicts;
+				uint64_t counted_propagations = solver.get_statistics().propagations;
+				uint64_t cube_start_conflicts = counted_conflicts;
+
+				while (not finished.load())
+				{
+					// Hasta `MIN_SPLIT_CONFLICTS` conflictos en el cubo actual no se acepta dividirlo: la
+					// busqueda corre primero con ese tope y sin que los demas hilos se lo pidan
+					uint64_t cube_conflicts = solver.get_statistics().conflicts - cube_start_conflicts;
+					bool splittable = cube_conflicts >= MIN_SPLIT_CONFLICTS;
+					self.splittable.store(splittable);
+					uint64_t conflict_limit = remaining(options.conflict_limit, used_conflicts.load());
+					if (not splittable)
+					{
+						uint64_t until_splittable = MIN_SPLIT_CONFLICTS - cube_conflicts;
+						conflict_limit = conflict_limit == 0 ? until_splittable : std::min(conflict_limit, until_splittable);
+					}
+					solver.set_limits(remaining_time(), conflict_limit,
+									  remaining(options.propagation_limit, used_propagations.load()), options.memory_limit);
+
+					bool satisfiable = solver.solve();
+					used_conflicts += solver.get_statistics().conflicts - counted_conflicts;
+					used_propagations += solver.get_statistics().propagations - counted_propagations;
+					counted_conflicts = solver.get_statistics().conflicts;
+					counted_propagations = solver.get_statistics().propagations;
+
+					if (solver.was_stopped())
+					{
+						if (finished.load())
+						{
+							break;
+						}
+						const std::string &reason = solver.get_statistics().stop_reason;
+						bool budget_left = options.conflict_limit == 0 or used_conflicts.load() < options.conflict_limit;
+						if (reason == "conflict limit" and not splittable and budget_left)
+						{
+							// Solo se llego al tope del cubo: desde ahora se puede dividir
+							continue;
+						}
+						if (reason != "interrupted")
+						{
+							// Se alcanzo un limite: toda la busqueda termina sin respuesta
+							std::lock_guard<std::mutex> lock(result_mutex);
+							if (not finished.load())
+							{
+								result.stopped = true;
+								result.statistics.stop_reason = reason;
+								finish();
+							}
+							break;
+						}
+						// `finish` tambien usa esta bandera: si llego despues de revisar `finished`, al
+						// borrarla se perderia, asi que se vuelve a revisar
+						self.split_request.store(false);
+						if (finished.load())
+						{
+							break;
+						}
+						if (not splittable)
+						{
+							// El pedido llego justo antes de que el hilo dejara de aceptarlos
+							continue;
+						}
+
+						// Nos quedamos con una mitad del cubo y dejamos la otra para quien la robe
+						int var = choose_cube_variable(base, cube);
+						if (var != 0)
+						{
+							Cube other = cube;
+							other.push_back(-var);
+							cube.push_back(var);
+							solver.add_clause(&var, 1);
+							cube_start_conflicts = solver.get_statistics().conflicts;
+							++outstanding;
+							++dynamic_splits;
+							std::lock_guard<std::mutex> lock(self.mutex);
+							self.cubes.push_back(std::move(other));
+						}
+						continue;
+					}
+
+					std::lock_guard<std::mutex> lock(result_mutex);
+					if (satisfiable)
+					{
+						if (not finished.load())
+						{
+							result.satisfiable = true;
+							result.model = solver.get_model();
+							finish();
+						}
+					}
+					else
+					{
+						++refuted_cubes;
+						if (--outstanding == 0)
+						{
+							finish();
+						}
+					}
+					break;
+				}
+				self.splittable.store(false);
+
+				{
+					// Todas las llamadas a `solve` del cubo, tambien las detenidas para dividirlo
+					std::lock_guard<std::mutex> lock(result_mutex);
+					add_statistics(result.statistics, solver.get_statistics());
+				}
+				self.busy.store(false);
+			}
+		}
+		catch (...)
+		{
+			// Un error en un hilo termina toda la busqueda; `solve_cubes` lo vuelve a lanzar
+			std::lock_guard<std::mutex> lock(result_mutex);
+			if (not worker_error)
+			{
+				worker_error = std::current_exception();
+			}
+			finish();
+			self.busy.store(false);
+		}
+		++finished_workers;
+	};
+
+	std::vector<std::thread> threads;
+	for (uint id = 0; id < num_workers; ++id)
+	{
+		threads.emplace_back(run_worker, id);
+	}
+	while (interrupt != nullptr and finished_workers.load() < num_workers)
+	{
+		if (interrupt->load(std::memory_order_relaxed))
+		{
+			std::lock_guard<std::mutex> lock(result_mutex);
+			if (not finished.load())
+			{
+				result.stopped = true;
+				result.statistics.stop_reason = "interrupted";
+				finish();
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(INTERRUPT_POLL_MS));
+	}
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	if (worker_error)
+	{
+		std::rethrow_exception(worker_error);
+	}
+
+	result.dynamic_splits = dynamic_splits.load();
+	result.refuted_cubes = refuted_cubes.load();
+	return result;
+}
@@ -0,0 +1,416 @@
+#include "dimacsParser.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <lzma.h>
+
+/**
+ * Tamaño de los fragmentos que se leen de la entrada estándar y de los archivos comprimidos.
+ */
+#define STREAM_CHUNK_SIZE (1 << 16)
+
+/**
+ * Máximo de literales que se reservan por la cantidad de cláusulas del encabezado cuando no se
+ * conoce el tamaño de la entrada (entrada estándar y archivos comprimidos).
+ */
+#define MAX_HEADER_RESERVE (1 << 24)
+
+/**
+ * @brief Indica si un caracter separa tokens (espacio, tabulador o salto de línea).
+ */
+static inline bool is_space(char c)
+{
+	return c == ' ' or c == '\n' or c == '\t' or c == '\r' or c == '\v' or c == '\f';
+}
+
+/**
+ * @brief Lee un entero con signo que empieza en `p` y deja `p` justo después de él.
+ *
+ * @throws std::runtime_error Si no hay un entero en `p` o si no cabe en un `int`.
+ */
+static int scan_int(const char *&p, const char *end)
+{
+	bool negative = false;
+	if (p < end and *p == '-')
+	{
+		negative = true;
+		++p;
+	}
+
+	if (p == end or *p < '0' or *p > '9')
+	{
+		throw std::runtime_error("Error: Se esperaba un entero en el archivo DIMACS");
+	}
+
+	long long value = 0;
+	while (p < end and *p >= '0' and *p <= '9')
+	{
+		value = value * 10 + (*p - '0');
+		if (value > INT_MAX)
+		{
+			throw std::runtime_error("Error: Entero demasiado grande en el archivo DIMACS");
+		}
+		++p;
+	}
+
+	if (p < end and not is_space(*p))
+	{
+		throw std::runtime_error(std::string("Error: Caracter inesperado en el archivo DIMACS: ") + *p);
+	}
+
+	return negative ? -value : value;
+}
+
+static inline void skip_spaces(const char *&p, const char *end)
+{
+	while (p < end and is_space(*p))
+	{
+		++p;
+	}
+}
+
+void DimacsParser::parse_lines(const char *p, const char *end)
+{
+	while (p < end and not finished)
+	{
+		char c = *p;
+		if (is_space(c))
+		{
+			++p;
+		}
+		else if (c == '-' or (c >= '0' and c <= '9'))
+		{
+			int literal = scan_int(p, end);
+			if (literal == 0)
+			{
+				formula.end_clause();
+				open_clause_size = 0;
+			}
+			else
+			{
+				formula.add_literal(literal);
+				++open_clause_size;
+			}
+		}
+		else if (c == 'c')
+		{
+			// Los comentarios llegan hasta el final de la linea
+			const char *newline = static_cast<const char *>(memchr(p, '\n', end - p));
+			p = newline == nullptr ? end : newline + 1;
+		}
+		else if (c == 'p')
+		{
+			// p cnf <variables> <clausulas>
+			++p;
+			skip_spaces(p, end);
+			if (end - p < 3 or strncmp(p, "cnf", 3) != 0)
+			{
+				throw std::runtime_error("Error: Encabezado DIMACS invalido");
+			}
+			p += 3;
+			skip_spaces(p, end);
+			int num_variables = scan_int(p, end);
+			skip_spaces(p, end);
+			int num_clauses = scan_int(p, end);
+			if (num_variables < 0 or num_clauses < 0)
+			{
+				throw std::runtime_error("Error: Encabezado DIMACS invalido");
+			}
+
+			// Los conteos del encabezado no se verifican, asi que solo sirven para reservar: las
+			// variables salen de las clausulas, y la reserva no pasa de lo que cabe en la entrada
+			// (cada literal ocupa al menos dos bytes) o, si no se conoce su tamano, de un tope.
+			// Casi todas las instancias son de clausulas de 3 literales: tres literales y un 0
+			size_t reserve = 4 * size_t(num_clauses);
+			reserve = std::min<size_t>(reserve, input_bytes > 0 ? input_bytes / 2 : MAX_HEADER_RESERVE);
+			formula.literals.reserve(reserve);
+		}
+		else if (c == '%')
+		{
+			finished = true;
+		}
+		else
+		{
+			throw std::runtime_error(std::string("Error: Caracter inesperado en el archivo DIMACS: ") + c);
+		}
+	}
+}
+
+void DimacsParser::parse(const char *begin, const char *end)
+{
+	if (not pending.empty())
+	{
+		// Completamos la linea que quedo cortada en el fragmento anterior
+		const char *newline = static_cast<const char *>(memchr(begin, '\n', end - begin));
+		if (newline == nullptr)
+		{
+			pending.append(begin, end);
+			return;
+		}
+		pending.append(begin, newline + 1);
+		parse_lines(pending.data(), pending.data() + pending.size());
+		pending.clear();
+		begin = newline + 1;
+	}
+
+	const char *last_newline = end;
+	while (last_newline > begin and last_newline[-1] != '\n')
+	{
+		--last_newline;
+	}
+
+	parse_lines(begin, last_newline);
+	pending.assign(last_newline, end);
+}
+
+void DimacsParser::finish()
+{
+	parse_lines(pending.data(), pending.data() + pending.size());
+	pending.clear();
+
+	if (open_clause_size > 0)
+	{
+		formula.end_clause();
+		open_clause_size = 0;
+	}
+}
+
+/**
+ * @brief Indica si `text` termina con `suffix`.
+ */
+static bool ends_with(const std::string &text, const std::string &suffix)
+{
+	return text.size() >= suffix.size() and text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * @brief Lee la entrada estándar por fragmentos y se los pasa al parser.
+ *
+ * @return La cantidad de bytes leídos.
+ */
+static uint64_t parse_DIMACS_stdin(DimacsParser &parser)
+{
+	std::vector<char> buffer(STREAM_CHUNK_SIZE);
+	uint64_t bytes = 0;
+	ssize_t read_bytes;
+	while ((read_bytes = read(STDIN_FILENO, buffer.data(), buffer.size())) > 0)
+	{
+		parser.parse(buffer.data(), buffer.data() + read_bytes);
+		bytes += read_bytes;
+	}
+	if (read_bytes < 0)
+	{
+		throw std::runtime_error("Error: No se puede leer la entrada estandar");
+	}
+	return bytes;
+}
+
+/**
+ * @brief Descomprime un archivo gzip por fragmentos y se los pasa al parser.
+ *
+ * @return La cantidad de bytes descomprimidos.
+ */
+static uint64_t parse_DIMACS_gzip(const std::string &file_path, DimacsParser &parser)
+{
+	gzFile file = gzopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		throw std::runtime_error("Error: No se puede abrir el archivo: " + file_path);
+	}
+	gzbuffer(file, STREAM_CHUNK_SIZE);
+
+	std::vector<char> buffer(STREAM_CHUNK_SIZE);
+	uint64_t bytes = 0;
+	int read_bytes;
+	try
+	{
+		while ((read_bytes = gzread(file, buffer.data(), buffer.size())) > 0)
+		{
+			parser.parse(buffer.data(), buffer.data() + read_bytes);
+			bytes += read_bytes;
+		}
+	}
+	catch (...)
+	{
+		gzclose(file);
+		throw;
+	}
+	gzclose(file);
+
+	if (read_bytes < 0)
+	{
+		throw std::runtime_error("Error: Archivo gzip corrupto: " + file_path);
+	}
+	return bytes;
+}
+
+/**
+ * @brief Descomprime un archivo xz por fragmentos y se los pasa al parser.
+ *
+ * @return La cantidad de bytes descomprimidos.
+ */
+static uint64_t parse_DIMACS_xz(const std::string &file_path, DimacsParser &parser)
+{
+	int fd = open(file_path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::runtime_error("Error: No se puede abrir el archivo: " + file_path);
+	}
+
+	lzma_stream stream = LZMA_STREAM_INIT;
+	if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+	{
+		close(fd);
+		throw std::runtime_error("Error: No se puede iniciar el descompresor xz");
+	}
+
+	std::vector<uint8_t> input(STREAM_CHUNK_SIZE);
+	std::vector<char> output(STREAM_CHUNK_SIZE);
+	uint64_t bytes = 0;
+	lzma_action action = LZMA_RUN;
+	lzma_ret status = LZMA_OK;
+	try
+	{
+		while (status != LZMA_STREAM_END)
+		{
+			if (stream.avail_in == 0 and action == LZMA_RUN)
+			{
+				ssize_t read_bytes = read(fd, input.data(), input.size());
+				if (read_bytes < 0)
+				{
+					throw std::runtime_error("Error: No se puede leer el archivo: " + file_path);
+				}
+				stream.next_in = input.data();
+				stream.avail_in = read_bytes;
+				if (read_bytes == 0)
+				{
+					action = LZMA_FINISH;
+				}
+			}
+
+			stream.next_out = reinterpret_cast<uint8_t *>(output.data());
+			stream.avail_out = output.size();
+			status = lzma_code(&stream, action);
+			if (status != LZMA_OK and status != LZMA_STREAM_END)
+			{
+				throw std::runtime_error("Error: Archivo xz corrupto: " + file_path);
+			}
+
+			size_t decoded_bytes = output.size() - stream.avail_out;
+			parser.parse(output.data(), output.data() + decoded_bytes);
+			bytes += decoded_bytes;
+		}
+	}
+	catch (...)
+	{
+		lzma_end(&stream);
+		close(fd);
+		throw;
+	}
+	lzma_end(&stream);
+	close(fd);
+	return bytes;
+}
+
+/**
+ * @brief Proyecta un archivo sin comprimir en memoria y se lo pasa completo al parser.
+ *
+ * @return El tamaño del archivo.
+ */
+static uint64_t parse_DIMACS_mmap(const std::string &file_path, DimacsParser &parser)
+{
+	int fd = open(file_path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::runtime_error("Error: No se puede abrir el archivo: " + file_path);
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0)
+	{
+		close(fd);
+		throw std::runtime_error("Error: No se puede leer el archivo: " + file_path);
+	}
+	uint64_t bytes = file_stat.st_size;
+
+	if (bytes == 0)
+	{
+		close(fd);
+		return 0;
+	}
+
+	void *data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		throw std::runtime_error("Error: No se puede leer el archivo: " + file_path);
+	}
+	madvise(data, bytes, MADV_SEQUENTIAL);
+
+	const char *text = static_cast<const char *>(data);
+	parser.set_input_bytes(bytes);
+	try
+	{
+		parser.parse(text, text + bytes);
+	}
+	catch (...)
+	{
+		munmap(data, bytes);
+		throw;
+	}
+	munmap(data, bytes);
+	return bytes;
+}
+
+ParseStatistics parse_DIMACS_file(const std::string &file_path, CnfFormula &formula)
+{
+	ParseStatistics statistics;
+	auto start_time = std::chrono::steady_clock::now();
+
+	DimacsParser parser(formula);
+	if (file_path == "-")
+	{
+		statistics.bytes = parse_DIMACS_stdin(parser);
+	}
+	else if (ends_with(file_path, ".gz"))
+	{
+		statistics.bytes = parse_DIMACS_gzip(file_path, parser);
+	}
+	else if (ends_with(file_path, ".xz"))
+	{
+		statistics.bytes = parse_DIMACS_xz(file_path, parser);
+	}
+	else
+	{
+		statistics.bytes = parse_DIMACS_mmap(file_path, parser);
+	}
+	parser.finish();
+
+	std::chrono::duration<double> elapsed_time = std::chrono::steady_clock::now() - start_time;
+	statistics.seconds = elapsed_time.count();
+	return statistics;
+}
+
+void write_DIMACS(const CnfFormula &formula, std::ostream &out)
+{
+	out << "p cnf " << formula.num_variables << " " << formula.num_clauses << "\n";
+	for (int literal : formula.literals)
+	{
+		if (literal == 0)
+		{
+			out << "0\n";
+		}
+		else
+		{
+			out << literal << " ";
+		}
+	}
+}
@@ -1,4 +1,9 @@
 #include "dpllSolver.h"
+#include "variableHeap.h"
+#include "clauseArena.h"
+#include "allocationCounter.h"
+#include "solverMonitor.h"
+#include <cmath>
 
 #define VERSION 3
 
@@ -478,8 +483,10 @@ bool dpll_solver_rec_mk2(std::vector<std::vector<int>> &clauses, std::set<int> s
 #  - Es intuitivo y facil de entender.
 #  - Es facil de implementar.
 #  - Es iterativo
-#  - Es eficiente (no hace copias, pero si pasa por todas las variables, esto puede llegar
-#	 a ser un pequeño problema)
+#  - Es eficiente (no hace copias y elige las decisiones con una cola de prioridad)
+#  - Por defecto propaga con dos literales vigilados por clausula (ver PROPAGATION_MODE)
+#  - Por defecto aprende clausulas de los conflictos y retrocede de forma no cronologica
+#    (ver SEARCH_MODE)
 #  Contras:
 #  - No utiliza los literales puros
 # Pruebas:
@@ -503,7 +510,7 @@ bool dpll_solver_rec_mk2(std::vector<std::vector<int>> &clauses, std::set<int> s
 #define DECISION_MARK 0
 
 /**
- * Una cantidad que se le suma a la actividad de un literal cada vez que este es parte de un conflicto.
+ * La cantidad inicial que se le suma a la actividad de un literal cada vez que este es parte de un conflicto.
  * Esta actividad se usa para decidir que literal se va a tomar como decision.
  * En pocas palabras se utiliza para tener una heuristica de decision. Tomaremos el literal que haya tenido
  * mas conflictos, para solucionarlo lo mas pronto posible.
@@ -511,80 +518,545 @@ bool dpll_solver_rec_mk2(std::vector<std::vector<int>> &clauses, std::set<int> s
 #define ACTIVITY_INCREMENT 1.0
 
 /**
- * Para que la heuristica funcion hay que dividir entre 2 el valor de la actividad cada vez que
- * se llega a un conflicto. Esto es para darle chance a otros literales de ser elegidos como decision.
- * En este caso se hace cada 1000 conflictos.
+ * Para darle chance a otros literales de ser elegidos como decision, en vez de dividir todas las
+ * actividades periodicamente se hace crecer el incremento despues de cada conflicto (se divide
+ * entre este factor). Asi los conflictos recientes pesan mas que los viejos.
  */
-#define ACT_INC_UPDATE_RATE 1000
+#define ACTIVITY_DECAY 0.95
 
-// Variables globales que se utilizan en varias funciones
+/**
+ * Cuando alguna actividad supera este valor se multiplican todas (y el incremento) por
+ * `1 / ACTIVITY_RESCALE_LIMIT` para que no se desborden. El orden entre variables no cambia.
+ */
+#define ACTIVITY_RESCALE_LIMIT 1e100
+
+/**
+ * Modos de propagacion disponibles para la tercera version.
+ * - OCCURRENCE_LISTS: por cada literal propagado se recorren todas las clausulas donde aparece negado.
+ * - WATCHED_LITERALS: cada clausula vigila dos de sus literales y solo se revisa cuando uno de ellos
+ *   se vuelve falso.
+ * Se puede cambiar al compilar con -DPROPAGATION_MODE=OCCURRENCE_LISTS.
+ */
+#define OCCURRENCE_LISTS 1
+
+#define WATCHED_LITERALS 2
+
+#ifndef PROPAGATION_MODE
+#define PROPAGATION_MODE WATCHED_LITERALS
+#endif
+
+/**
+ * Modos de busqueda disponibles para la tercera version.
+ * - CHRONOLOGICAL_BACKTRACKING: ante un conflicto se invierte la ultima decision tomada.
+ * - CDCL: ante un conflicto se aprende una clausula (1-UIP) y se retrocede directamente
+ *   al nivel donde esa clausula se vuelve unitaria.
+ * Se puede cambiar al compilar con -DSEARCH_MODE=CHRONOLOGICAL_BACKTRACKING.
+ */
+#define CHRONOLOGICAL_BACKTRACKING 1
 
-uint num_variables;
+#define CDCL 2
 
-uint num_clauses;
+#ifndef SEARCH_MODE
+#define SEARCH_MODE CDCL
+#endif
 
-std::vector<std::vector<int>> clauses;
+/**
+ * Con `RESTART_GEOMETRIC` cada intervalo entre reinicios es este factor por el anterior.
+ */
+#define RESTART_GEOMETRIC_FACTOR 1.5
 
 /**
- * Una lista que contiene las clausulas donde un literal aparece de manera positiva.
+ * Con `RESTART_GLUCOSE` se compara el LBD promedio de las ultimas `GLUCOSE_LBD_WINDOW` clausulas
+ * aprendidas con el de toda la busqueda, y se reinicia si el reciente por `GLUCOSE_RESTART_K`
+ * es mayor: la busqueda esta aprendiendo clausulas peores que de costumbre.
  */
-std::vector<std::vector<std::vector<int> *>> positive_clauses;
+#define GLUCOSE_LBD_WINDOW 50
+
+#define GLUCOSE_RESTART_K 0.8
 
 /**
- * Una lista que contiene las clausulas donde un literal aparece de manera negativa.
+ * Cada reducción de la base de cláusulas aprendidas llega `REDUCE_INTERVAL_INCREMENT` conflictos
+ * más tarde que la anterior, así la base crece despacio a medida que la búsqueda avanza.
  */
-std::vector<std::vector<std::vector<int> *>> negative_clauses;
+#define REDUCE_INTERVAL_INCREMENT 300
 
-std::vector<int> model;
+/**
+ * Las cláusulas aprendidas con LBD menor o igual ("glue") nunca se borran.
+ */
+#define LEARNED_GLUE_LBD 2
 
 /**
- * una pila que contendra todas las decisiones que se han tomado.
+ * Igual que `ACTIVITY_DECAY`, pero para la actividad de las cláusulas aprendidas.
  */
-std::vector<int> model_stack;
+#define CLAUSE_ACTIVITY_DECAY 0.999
 
 /**
- * El indice de la siguiente literal que se va a propagar.
+ * Las actividades de las cláusulas son `float`, así que se reescalan mucho antes que las de los literales.
  */
-uint index_of_next_literal_to_propagate;
+#define CLAUSE_ACTIVITY_RESCALE_LIMIT 1e20
 
 /**
- * la profundidad del arbol de decision.
+ * El arena se compacta después de una reducción si más de esta fracción de sus palabras es de
+ * cláusulas borradas.
  */
-uint decision_level;
+#define ARENA_WASTE_LIMIT 0.25
 
 /**
- * Cantidad de conflictos que se han encontrado donde un literal esta en forma positiva.
+ * Cantidad de variables (las que aparecen en más cláusulas) que prueba `choose_lookahead_variable`.
  */
-std::vector<double> positive_literal_activity;
+#define LOOKAHEAD_CANDIDATES 32
 
 /**
- * Cantidad de conflictos que se han encontrado donde un literal esta en forma negativa.
+ * @brief Devuelve el termino `x` (desde 0) de la sucesion de Luby escalada por `y`:
+ *        1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ... con `y` = 2.
  */
-std::vector<double> negative_literal_activity;
+static double luby(double y, uint64_t x)
+{
+	// Buscamos la subsucesion completa (de tamaño 2^k - 1) que contiene a x
+	uint64_t size = 1;
+	int sequence = 0;
+	while (size < x + 1)
+	{
+		++sequence;
+		size = 2 * size + 1;
+	}
 
-uint conflicts;
+	while (size - 1 != x)
+	{
+		size = (size - 1) >> 1;
+		--sequence;
+		x = x % size;
+	}
 
-uint propagations;
+	return std::pow(y, sequence);
+}
 
-uint decisions;
+// El estado de la busqueda vive en la clase Solver (ver dpllSolver.h)
 
 inline uint literal_var(int literal)
 {
 	return abs(literal);
 }
 
+Solver::Solver(const SolverOptions &options) : options(options)
+{
+	num_variables = 0;
+	empty_clause_added = false;
+	preprocessed = false;
+	conflicting_clause = CLAUSE_REF_UNDEF;
+	index_of_next_literal_to_propagate = 0;
+	decision_level = 0;
+	activity_increment = ACTIVITY_INCREMENT;
+	clause_activity_increment = ACTIVITY_INCREMENT;
+	reduce_interval = options.reduce_interval;
+	next_reduce = options.reduce_interval;
+
+	conflicts_since_restart = 0;
+	solve_restarts = 0;
+	recent_lbds_next = 0;
+	recent_lbds_sum = 0;
+	total_lbds_sum = 0;
+	current_level_stamp = 0;
+	update_restart_limit();
+
+	// El generador no funciona con estado 0
+	random_state = options.random_seed != 0 ? options.random_seed : 1;
+
+	// La variable 0 no existe, pero ocupa la posicion 0 de todos los vectores
+	grow_variables(0);
+}
+
+/**
+ * @brief Devuelve la cantidad de clausulas donde aparece un literal.
+ */
+inline uint &Solver::occurrences(int literal)
+{
+	return literal > 0 ? positive_occurrences[literal_var(literal)] : negative_occurrences[literal_var(literal)];
+}
+
+/**
+ * @brief Devuelve la lista de clausulas que vigilan a un literal.
+ */
+inline std::vector<ClauseRef> &Solver::watch_list(int literal)
+{
+	return literal > 0 ? positive_watches[literal_var(literal)] : negative_watches[literal_var(literal)];
+}
+
+/**
+ * @brief Agrega las variables hasta `max_var` a todas las estructuras indexadas por variable.
+ *
+ * Las variables nuevas quedan sin asignar, con actividad 0 y dentro de `decision_heap`.
+ *
+ * @param max_var La mayor variable que debe existir despues de la llamada.
+ */
+void Solver::grow_variables(uint max_var)
+{
+	if (max_var < model.size())
+	{
+		return;
+	}
+
+	uint first_new_var = model.size();
+
+	positive_clauses.resize(max_var + 1);
+	negative_clauses.resize(max_var + 1);
+	positive_watches.resize(max_var + 1);
+	negative_watches.resize(max_var + 1);
+	positive_occurrences.resize(max_var + 1, 0);
+	negative_occurrences.resize(max_var + 1, 0);
+
+	model.resize(max_var + 1, UNASSIGNED);
+	variable_level.resize(max_var + 1, 0);
+	variable_reason.resize(max_var + 1, CLAUSE_REF_UNDEF);
+	seen.resize(max_var + 1, false);
+	// Nunca hay mas niveles de decision que variables
+	level_stamp.resize(max_var + 1, 0);
+
+	positive_literal_activity.resize(max_var + 1, 0.0);
+	negative_literal_activity.resize(max_var + 1, 0.0);
+	saved_phase.resize(max_var + 1, UNASSIGNED);
+	decision_heap.grow(max_var);
+	for (uint var = std::max(first_new_var, 1u); var <= max_var; ++var)
+	{
+		decision_heap.insert(var);
+	}
+
+	// La pila nunca tiene mas que cada variable una vez y una marca por decision, asi que
+	// se reserva de una vez para que la propagacion no tenga que pedir memoria
+	model_stack.reserve(2 * max_var + 1);
+	num_variables = max_var;
+}
+
+void Solver::reserve(uint num_variables, uint num_clauses)
+{
+	grow_variables(num_variables);
+	clauses.reserve(num_clauses);
+
+	// Casi todas las instancias son de clausulas de 3 literales: un encabezado y tres literales
+	clause_arena.reserve(4 * num_clauses);
+}
+
+/**
+ * @brief Registra una cláusula del arena en las estructuras de propagación.
+ *
+ * Actualiza la cantidad de apariciones de cada literal y agrega la cláusula a las listas de
+ * apariciones (modo `OCCURRENCE_LISTS`) o a las listas de vigilancia de sus dos primeros
+ * literales (modo `WATCHED_LITERALS`).
+ *
+ * @param clause_ref La referencia a la cláusula dentro de `clause_arena`.
+ *
+ * @details
+ * - Una lista de vigilancia nunca tiene más cláusulas que las que contienen al literal, así
+ *   que su capacidad se amplía aquí para que al mover vigilancias durante la propagación nunca
+ *   haga falta pedir memoria.
+ * - Las cláusulas unitarias no vigilan ningún literal, las maneja `check_unit_clauses`.
+ */
+void Solver::attach_clause(ClauseRef clause_ref)
+{
+	Clause clause = clause_arena.clause(clause_ref);
+
+	for (int literal : clause)
+	{
+		++occurrences(literal);
+
+#if PROPAGATION_MODE == OCCURRENCE_LISTS
+		// llenamos las listas de apariciones positivas y negativas
+		if (literal > 0)
+		{
+			positive_clauses[literal_var(literal)].push_back(clause_ref);
+		}
+		else
+		{
+			negative_clauses[literal_var(literal)].push_back(clause_ref);
+		}
+#else
+		std::vector<ClauseRef> &watches = watch_list(literal);
+		if (watches.capacity() < occurrences(literal))
+		{
+			watches.reserve(2 * occurrences(literal));
+		}
+#endif
+	}
+
+#if PROPAGATION_MODE == WATCHED_LITERALS
+	if (clause.size() >= 2)
+	{
+		watch_list(clause[0]).push_back(clause_ref);
+		watch_list(clause[1]).push_back(clause_ref);
+	}
+#endif
+}
+
+bool Solver::add_clause(const std::vector<int> &literals)
+{
+	return add_clause(literals.data(), literals.size());
+}
+
+bool Solver::add_clause(const int *literals, uint size)
+{
+	if (preprocessed)
+	{
+		for (uint i = 0; i < size; ++i)
+		{
+			if (preprocessor.is_eliminated(literal_var(literals[i])))
+			{
+				throw std::runtime_error("Error: La variable " + std::to_string(literal_var(literals[i])) +
+										 " fue eliminada al preprocesar la formula");
+			}
+		}
+		for (uint i = 0; i < size; ++i)
+		{
+			original_formula.add_literal(literals[i]);
+		}
+		original_formula.end_clause();
+	}
+
+	for (uint i = 0; i < size; ++i)
+	{
+		grow_variables(literal_var(literals[i]));
+	}
+
+	// Entre dos llamadas a solve: se deshace la busqueda anterior y se simplifica la clausula con
+	// los valores del nivel 0, que son definitivos, para que sus vigilancias no empiecen en falso
+	std::vector<int> simplified;
+	if (not model_stack.empty())
+	{
+		backjump(0);
+		for (uint i = 0; i < size; ++i)
+		{
+			int value = get_literal_value(literals[i]);
+			if (value == TRUE)
+			{
+				return true;
+			}
+			if (value == UNASSIGNED)
+			{
+				simplified.push_back(literals[i]);
+			}
+		}
+		literals = simplified.data();
+		size = simplified.size();
+	}
+
+	if (size == 0)
+	{
+		empty_clause_added = true;
+		return false;
+	}
+
+	ClauseRef clause_ref = clause_arena.allocate(literals, size, false);
+	clauses.push_back(clause_ref);
+	attach_clause(clause_ref);
+	return true;
+}
+
+bool Solver::add_formula(const CnfFormula &formula)
+{
+	grow_variables(formula.num_variables);
+	clauses.reserve(clauses.size() + formula.num_clauses);
+
+	// Cada clausula ocupa en el arena un encabezado y sus literales, lo mismo que en
+	// la formula sus literales y el 0 final
+	clause_arena.reserve(clause_arena.words() + formula.literals.size());
+
+	// Contamos las apariciones de cada literal para reservar sus listas de una vez
+	std::vector<uint> new_positive(num_variables + 1, 0);
+	std::vector<uint> new_negative(num_variables + 1, 0);
+	for (int literal : formula.literals)
+	{
+		if (literal > 0)
+		{
+			++new_positive[literal];
+		}
+		else if (literal < 0)
+		{
+			++new_negative[-literal];
+		}
+	}
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+#if PROPAGATION_MODE == WATCHED_LITERALS
+		positive_watches[var].reserve(positive_occurrences[var] + new_positive[var]);
+		negative_watches[var].reserve(negative_occurrences[var] + new_negative[var]);
+#else
+		positive_clauses[var].reserve(positive_occurrences[var] + new_positive[var]);
+		negative_clauses[var].reserve(negative_occurrences[var] + new_negative[var]);
+#endif
+	}
+
+	const int *clause_begin = formula.literals.data();
+	const int *formula_end = clause_begin + formula.literals.size();
+	while (clause_begin < formula_end)
+	{
+		const int *clause_end = clause_begin;
+		while (*clause_end != 0)
+		{
+			++clause_end;
+		}
+		add_clause(clause_begin, clause_end - clause_begin);
+		clause_begin = clause_end + 1;
+	}
+
+	return not empty_clause_added;
+}
+
+bool parse_solver_option(int argc, char *argv[], int &i, SolverOptions &options)
+{
+	std::string arg = argv[i];
+	if (arg == "--preprocess" or arg == "--no-preprocess")
+	{
+		options.preprocess = arg == "--preprocess";
+		return true;
+	}
+
+	if (i + 1 >= argc)
+	{
+		return false;
+	}
+	std::string value = argv[i + 1];
+
+	if (arg == "--restart")
+	{
+		if (value == "none")
+		{
+			options.restart_policy = RESTART_NONE;
+		}
+		else if (value == "luby")
+		{
+			options.restart_policy = RESTART_LUBY;
+		}
+		else if (value == "geometric")
+		{
+			options.restart_policy = RESTART_GEOMETRIC;
+		}
+		else if (value == "glucose")
+		{
+			options.restart_policy = RESTART_GLUCOSE;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else if (arg == "--polarity")
+	{
+		if (value == "saved")
+		{
+			options.polarity = POLARITY_SAVED;
+		}
+		else if (value == "false")
+		{
+			options.polarity = POLARITY_FALSE;
+		}
+		else if (value == "true")
+		{
+			options.polarity = POLARITY_TRUE;
+		}
+		else if (value == "random")
+		{
+			options.polarity = POLARITY_RANDOM;
+		}
+		else if (value == "activity")
+		{
+			options.polarity = POLARITY_ACTIVITY;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else if (arg == "--seed")
+	{
+		options.random_seed = std::strtoull(value.c_str(), nullptr, 10);
+	}
+	else if (arg == "--reduce-interval")
+	{
+		char *end;
+		unsigned long interval = std::strtoul(value.c_str(), &end, 10);
+		if (value.empty() or *end != '\0')
+		{
+			return false;
+		}
+		options.reduce_interval = interval;
+	}
+	else if (arg == "--restart-interval")
+	{
+		int interval = std::atoi(value.c_str());
+		if (interval <= 0)
+		{
+			return false;
+		}
+		options.restart_interval = interval;
+	}
+	else if (arg == "--time-limit")
+	{
+		char *end;
+		double seconds = std::strtod(value.c_str(), &end);
+		if (value.empty() or *end != '\0' or seconds < 0)
+		{
+			return false;
+		}
+		options.time_limit = seconds;
+	}
+	else if (arg == "--conflict-limit" or arg == "--propagation-limit" or arg == "--mem-limit")
+	{
+		char *end;
+		unsigned long long limit = std::strtoull(value.c_str(), &end, 10);
+		if (value.empty() or *end != '\0' or value[0] == '-')
+		{
+			return false;
+		}
+		if (arg == "--conflict-limit")
+		{
+			options.conflict_limit = limit;
+		}
+		else if (arg == "--propagation-limit")
+		{
+			options.propagation_limit = limit;
+		}
+		else
+		{
+			options.memory_limit = limit;
+		}
+	}
+	else
+	{
+		return false;
+	}
+
+	++i;
+	return true;
+}
+
+void print_solver_options_usage(std::ostream &out)
+{
+	out << "Solver options:" << std::endl;
+	out << "  --restart none|luby|geometric|glucose  (default: geometric)" << std::endl;
+	out << "  --restart-interval <conflicts>         (default: 100)" << std::endl;
+	out << "  --polarity saved|false|true|random|activity  (default: activity)" << std::endl;
+	out << "  --seed <n>                             random seed for --polarity random" << std::endl;
+	out << "  --reduce-interval <conflicts>          first learned clause reduction, 0 keeps all (default: 2000)" << std::endl;
+	out << "  --preprocess, --no-preprocess          simplify the formula before the search (default: off)" << std::endl;
+	out << "  --time-limit <seconds>                 give up with UNKNOWN after this time, 0 for none (default: 0)" << std::endl;
+	out << "  --conflict-limit <conflicts>           give up with UNKNOWN after this many conflicts (default: 0)" << std::endl;
+	out << "  --propagation-limit <propagations>     give up with UNKNOWN after this many propagations (default: 0)" << std::endl;
+	out << "  --mem-limit <megabytes>                give up with UNKNOWN above this resident memory (default: 0)" << std::endl;
+}
+
 /**
  * @brief Parsea un archivo en formato DIMACS y lo convierte en una representación interna para el algoritmo DPLL.
  *
- * Esta función lee un archivo en formato DIMACS, que contiene un problema de satisfacibilidad booleana (SAT),
- * y lo convierte en una estructura interna que incluye las cláusulas, las variables y otras estructuras necesarias
- * para ejecutar el algoritmo DPLL.
+ * El archivo se lee con `parse_DIMACS_file` (proyectado en memoria, sin copiarlo) a una `CnfFormula`
+ * y luego se agrega al solver con `Solver::add_formula`, que reserva todo el espacio de una vez.
  *
  * @param file_path Una cadena de texto que contiene la ruta del archivo en formato DIMACS.
  *                  Este archivo debe incluir:
  *                  - Comentarios opcionales que comienzan con 'c'.
  *                  - Una línea de encabezado que comienza con 'p' y especifica el número de variables y cláusulas.
  *                  - Las cláusulas, donde cada línea contiene literales separados por espacios y termina con un '0'.
+ * @param solver El solver donde se agregan las cláusulas.
+ *
+ * @return El tamaño del archivo y el tiempo que tomó leerlo (sin contar `add_formula`).
  *
  * @throws std::runtime_error Si:
  *         - El archivo no se puede abrir.
@@ -596,66 +1068,24 @@ inline uint literal_var(int literal)
  *       1 -3 0
  *       2 3 -1 0
  *
- * @note Estructuras internas generadas:
- *       - `clauses`: Un vector de cláusulas, donde cada cláusula es un vector de literales (enteros).
+ * @note Estructuras internas generadas en el solver:
+ *       - `clause_arena`: El almacén contiguo donde quedan guardados los literales de todas las cláusulas.
+ *       - `clauses`: Las referencias a cada cláusula original dentro de `clause_arena`.
  *       - `positive_clauses`: Una lista de las cláusulas donde cada literal aparece de forma positiva.
  *       - `negative_clauses`: Una lista de las cláusulas donde cada literal aparece de forma negativa.
+ *       - `positive_watches` y `negative_watches`: Las cláusulas que vigilan a cada literal (solo en modo `WATCHED_LITERALS`).
  *       - `model`: Un vector que representa el modelo actual (asignación de valores a las variables).
  *       - `model_stack`: Una pila que contiene las decisiones tomadas durante la ejecución del algoritmo.
+ *       - `variable_level` y `variable_reason`: El nivel y la cláusula que implicó cada asignación.
  *       - `positive_literal_activity` y `negative_literal_activity`: Actividad de los literales para la heurística de decisión.
+ *       - `decision_heap`: La cola de prioridad con todas las variables, ordenada por actividad.
  */
-void parse_DIMACS_input(const std::string &file_path)
+ParseStatistics parse_DIMACS_input(const std::string &file_path, Solver &solver)
 {
-	std::ifstream file(file_path);
-	if (!file.is_open())
-	{
-		throw std::runtime_error("Error: No se puede abrir el archivo: " + file_path);
-	}
-
-	// Si hay comentarios los ignoramos
-	char c = file.get();
-	while (c == 'c')
-	{
-		while (c != '\n')
-			c = file.get();
-		c = file.get();
-	}
-
-	std::string aux;
-	file >> aux >> num_variables >> num_clauses;
-	clauses.resize(num_clauses);
-
-	positive_clauses.resize(num_variables + 1);
-	negative_clauses.resize(num_variables + 1);
-
-	for (uint clause = 0; clause < num_clauses; ++clause)
-	{
-		int literal;
-		while (file >> literal && literal != 0)
-		{
-			clauses[clause].push_back(literal);
-
-			// llenamos las listas de apariciones positivas y negativas
-			if (literal > 0)
-			{
-				positive_clauses[literal_var(literal)].push_back((std::vector<int> *)&clauses[clause]);
-			}
-			else
-			{
-				negative_clauses[literal_var(literal)].push_back((std::vector<int> *)&clauses[clause]);
-			}
-		}
-	}
-
-	model.resize(num_variables + 1, UNASSIGNED);
-	index_of_next_literal_to_propagate = 0;
-	decision_level = 0;
-
-	positive_literal_activity.resize(num_variables + 1, 0.0);
-	negative_literal_activity.resize(num_variables + 1, 0.0);
-	conflicts = 0;
-	propagations = 0;
-	decisions = 0;
+	CnfFormula formula;
+	ParseStatistics statistics = parse_DIMACS_file(file_path, formula);
+	solver.add_formula(formula);
+	return statistics;
 }
 
 /**
@@ -672,7 +1102,7 @@ void parse_DIMACS_input(const std::string &file_path)
  *         - `FALSE` (0) si el literal es falso.
  *         - `UNASSIGNED` (-1) si el literal no ha sido asignado en el modelo.
  */
-int get_literal_value(int literal)
+int Solver::get_literal_value(int literal) const
 {
 	if (literal >= 0)
 	{
@@ -701,12 +1131,15 @@ int get_literal_value(int literal)
  * @param literal Un entero que representa el literal a asignar como verdadero.
  *                Los literales positivos representan variables verdaderas,
  *                y los literales negativos representan variables falsas.
+ * @param reason La cláusula que obliga a asignar el literal, o `CLAUSE_REF_UNDEF` si es una decisión.
  */
-void set_literal_to_true(int literal)
+void Solver::set_literal_to_true(int literal, ClauseRef reason)
 {
 	// Si entramos aquí estamos tomando una decisión
 	// por eso es que agregamos el literal a la pila
 	model_stack.push_back(literal);
+	variable_level[literal_var(literal)] = decision_level;
+	variable_reason[literal_var(literal)] = reason;
 
 	if (literal > 0)
 	{
@@ -718,6 +1151,23 @@ void set_literal_to_true(int literal)
 	}
 }
 
+/**
+ * @brief Desasigna la variable de un literal al retroceder.
+ *
+ * Guarda en `saved_phase` el valor que tenía (para `POLARITY_SAVED`) y la vuelve a poner en
+ * `decision_heap` para que se pueda elegir como decisión.
+ *
+ * @param literal El literal de la pila que se deshace.
+ */
+void Solver::unassign(int literal)
+{
+	uint var = literal_var(literal);
+	saved_phase[var] = model[var];
+	model[var] = UNASSIGNED;
+	variable_reason[var] = CLAUSE_REF_UNDEF;
+	decision_heap.insert(var);
+}
+
 /**
  * @brief Actualiza la actividad asociada a un literal.
  *
@@ -729,21 +1179,35 @@ void set_literal_to_true(int literal)
  *                debe ser actualizada. Si es positivo, incrementará la actividad
  *                positiva; si es negativo, incrementará la actividad negativa.
  *
- * @note Se asume que las variables globales `positive_literal_activity` y
- *       `negative_literal_activity` están previamente definidas y son accesibles
- *       dentro del ámbito de esta función.
+ * @details
+ *  - Se suma `activity_increment`, que crece después de cada conflicto.
+ *  - Si la actividad supera `ACTIVITY_RESCALE_LIMIT` se reescalan todas las actividades.
+ *  - La posición de la variable en `decision_heap` se actualiza en O(log n).
+ *
+ * @note La actividad de la variable (el máximo de sus dos literales) la guarda `decision_heap`.
  *
  */
-void update_activity_literal(int literal)
+void Solver::update_activity_literal(int literal)
 {
 	uint index = literal_var(literal);
-	if (literal > 0)
+	double &activity = literal > 0 ? positive_literal_activity[index] : negative_literal_activity[index];
+	activity += activity_increment;
+
+	if (activity > decision_heap.activity(index))
 	{
-		positive_literal_activity[index] += ACTIVITY_INCREMENT;
+		decision_heap.set_activity(index, activity);
 	}
-	else
+
+	if (activity > ACTIVITY_RESCALE_LIMIT)
 	{
-		negative_literal_activity[index] += ACTIVITY_INCREMENT;
+		// Multiplicar todo por la misma constante no cambia el orden del heap
+		for (uint i = 1; i <= num_variables; ++i)
+		{
+			positive_literal_activity[i] /= ACTIVITY_RESCALE_LIMIT;
+			negative_literal_activity[i] /= ACTIVITY_RESCALE_LIMIT;
+		}
+		decision_heap.scale_activities(1 / ACTIVITY_RESCALE_LIMIT);
+		activity_increment /= ACTIVITY_RESCALE_LIMIT;
 	}
 }
 
@@ -751,46 +1215,77 @@ void update_activity_literal(int literal)
  * @brief Actualiza la actividad de los literales en una cláusula conflictiva.
  *
  * Esta función se invoca cuando se detecta una cláusula conflictiva durante el
- * proceso de resolución. Incrementa el contador de conflictos y realiza un ajuste
- * en las actividades de todos los literales si se cumple una tasa de actualización
- * definida. Finalmente, actualiza las actividades de los literales de la cláusula dada.
+ * proceso de resolución. Incrementa el contador de conflictos, actualiza las
+ * actividades de los literales de la cláusula dada y hace crecer el incremento
+ * para los conflictos siguientes.
  *
- * @param clause Un vector de enteros que representa la cláusula conflictiva.
- *               Cada entero corresponde a un literal en la cláusula.
+ * @param clause La referencia a la cláusula conflictiva dentro de `clause_arena`.
  *
  * @details
- *  - Si el número de conflictos alcanza un múltiplo de `ACT_INC_UPDATE_RATE`,
- *    las actividades de todos los literales se reducen a la mitad.
  *  - Para cada literal en la cláusula, se invoca la función
  *    `update_activity_literal` para incrementar su actividad específica.
+ *  - El incremento se divide entre `ACTIVITY_DECAY`, lo que equivale a reducir
+ *    la actividad de todos los literales sin tener que recorrerlos.
  *
  * @note Las variables globales `conflicts`, `positive_literal_activity`,
- *       `negative_literal_activity`, `ACT_INC_UPDATE_RATE` y `num_variables`
+ *       `negative_literal_activity`, `activity_increment` y `num_variables`
  *       deben estar correctamente inicializadas y configuradas antes de llamar
  *       a esta función.
  */
-void update_activity_conflicting_clause(const std::vector<int> &clause)
+void Solver::update_activity_conflicting_clause(ClauseRef clause)
 {
-	++conflicts;
-	if (conflicts % ACT_INC_UPDATE_RATE == 0)
-	{
-		for (uint i = 1; i <= num_variables; ++i)
-		{
-			positive_literal_activity[i] /= 2.0;
-			negative_literal_activity[i] /= 2.0;
-		}
-	}
+	++statistics.conflicts;
+	statistics.conflict_level_sum += decision_level;
 
-	for (int literal : clause)
+	for (int literal : clause_arena.clause(clause))
 	{
 		update_activity_literal(literal);
 	}
+
+	activity_increment /= ACTIVITY_DECAY;
+	clause_activity_increment /= CLAUSE_ACTIVITY_DECAY;
 }
+
 /**
- * @brief Propaga los literales en el modelo para identificar posibles conflictos.
+ * @brief Aumenta la actividad de una cláusula aprendida que participó en un conflicto y, si su
+ *        LBD bajó desde que se aprendió, lo actualiza.
  *
- * Esta función realiza la propagación de literales en la pila del modelo para
- * verificar si existen conflictos en las cláusulas asociadas. Si se encuentra
+ * @details
+ *  - Si la actividad supera `CLAUSE_ACTIVITY_RESCALE_LIMIT` se reescalan las actividades de
+ *    todas las cláusulas aprendidas.
+ *  - Solo se llama con razones de un conflicto, cuyos literales están todos asignados, así que
+ *    el LBD se puede recalcular con los niveles actuales.
+ */
+void Solver::update_activity_clause(ClauseRef clause_ref)
+{
+	float activity = clause_arena.activity(clause_ref) + clause_activity_increment;
+	clause_arena.set_activity(clause_ref, activity);
+
+	if (activity > CLAUSE_ACTIVITY_RESCALE_LIMIT)
+	{
+		for (ClauseRef learned_ref : learned_clauses)
+		{
+			clause_arena.set_activity(learned_ref, clause_arena.activity(learned_ref) / CLAUSE_ACTIVITY_RESCALE_LIMIT);
+		}
+		clause_activity_increment /= CLAUSE_ACTIVITY_RESCALE_LIMIT;
+	}
+
+	uint lbd = clause_arena.lbd(clause_ref);
+	if (lbd > LEARNED_GLUE_LBD)
+	{
+		Clause clause = clause_arena.clause(clause_ref);
+		uint new_lbd = compute_lbd(clause.begin(), clause.end());
+		if (new_lbd < lbd)
+		{
+			clause_arena.set_lbd(clause_ref, new_lbd);
+		}
+	}
+}
+/**
+ * @brief Propaga los literales en el modelo recorriendo las listas de apariciones.
+ *
+ * Esta función realiza la propagación de literales en la pila del modelo para
+ * verificar si existen conflictos en las cláusulas asociadas. Si se encuentra
  * una cláusula conflictiva, se actualizan las actividades heurísticas y se
  * devuelve un valor de conflicto. En caso contrario, asigna valores a los
  * literales no asignados en cláusulas unitarias.
@@ -810,7 +1305,7 @@ void update_activity_conflicting_clause(const std::vector<int> &clause)
  *       `get_literal_value`, `update_activity_conflicting_clause`, y `set_literal_to_true`
  *       deben estar correctamente definidas y configuradas antes de invocar esta función.
  */
-bool propagate_conflicts()
+bool Solver::propagate_occurrence_lists()
 {
 	while (index_of_next_literal_to_propagate < model_stack.size())
 	{
@@ -821,16 +1316,18 @@ bool propagate_conflicts()
 		++index_of_next_literal_to_propagate;
 
 		// Esto no es necesario si no se muestra al usuario lo puedo quitar sin problemas
-		++propagations;
+		++statistics.propagations;
 
 		// Aquí vamos a filtrar las clausulas que vamos a revisar a solo en las que el
 		// el literal se vuelve false, esto por que un "conflicto" es cuando una clausula
 		// esta vacia (osea todos los valores son false)
-		std::vector<std::vector<int> *> clauses_to_propagate = literal_to_propagate > 0 ? negative_clauses[literal_var(literal_to_propagate)] : positive_clauses[literal_var(literal_to_propagate)];
+		// La lista se recorre en su lugar: no cambia durante la propagacion porque los literales
+		// que se asignan solo se agregan a la pila y se propagan en una vuelta posterior
+		const std::vector<ClauseRef> &clauses_to_propagate = literal_to_propagate > 0 ? negative_clauses[literal_var(literal_to_propagate)] : positive_clauses[literal_var(literal_to_propagate)];
 
-		for (const auto &clause_ptr : clauses_to_propagate)
+		for (ClauseRef clause_ref : clauses_to_propagate)
 		{
-			const std::vector<int> &clause = *clause_ptr;
+			const Clause clause = clause_arena.clause(clause_ref);
 
 			bool is_some_literal_true = false;
 			int unassigned_literal = 0;
@@ -857,7 +1354,8 @@ bool propagate_conflicts()
 				// por lo tanto tenemos un conflicto
 
 				// actualizamos los valores para la heuristica
-				update_activity_conflicting_clause(clause);
+				conflicting_clause = clause_ref;
+				update_activity_conflicting_clause(clause_ref);
 				return true;
 			}
 			else if (not is_some_literal_true and unassigned_literal == 1)
@@ -865,14 +1363,132 @@ bool propagate_conflicts()
 				// Si llegamos aquí es por que la clausula es unitaria
 				// por lo tanto tenemos que asignar el valor del literal
 				// y volver a verificar si no se creo un conflicto
-				set_literal_to_true(last_unassigned_literal);
+				set_literal_to_true(last_unassigned_literal, clause_ref);
+			}
+		}
+	}
+	// Si llega aquí es por que no se ha encontrado un conflicto
+	return false;
+}
+
+/**
+ * @brief Propaga los literales en el modelo usando dos literales vigilados por cláusula.
+ *
+ * Cada cláusula de dos o más literales vigila sus dos primeras posiciones. Cuando un literal
+ * vigilado se vuelve falso se busca otro literal no falso para vigilar; si no existe, la
+ * cláusula es unitaria (se asigna el otro literal vigilado) o conflictiva (ambos son falsos).
+ *
+ * @return `true` si se detecta un conflicto; `false` si no se encuentra ninguno.
+ *
+ * @details
+ * - Solo se visitan las cláusulas que vigilan el literal que se acaba de volver falso, por lo
+ *   que no hace falta revisar todos los literales de todas las cláusulas donde aparece.
+ * - Las listas de vigilancia no se deshacen al retroceder: los literales vigilados siguen
+ *   siendo válidos cuando se desasignan variables.
+ * - El literal falso siempre se mueve a la posición 1 de la cláusula, de modo que la posición 0
+ *   queda con el otro literal vigilado.
+ */
+bool Solver::propagate_watched_literals()
+{
+	while (index_of_next_literal_to_propagate < model_stack.size())
+	{
+		int literal_to_propagate = model_stack[index_of_next_literal_to_propagate];
+
+		++index_of_next_literal_to_propagate;
+
+		++statistics.propagations;
+
+		// El literal que se vuelve falso es el opuesto al que se acaba de asignar
+		int false_literal = -literal_to_propagate;
+		std::vector<ClauseRef> &watches = watch_list(false_literal);
+
+		// i recorre la lista y j indica donde se guardan las vigilancias que se quedan
+		uint i = 0;
+		uint j = 0;
+		while (i < watches.size())
+		{
+			ClauseRef clause_ref = watches[i];
+			Clause clause = clause_arena.clause(clause_ref);
+
+			if (clause[0] == false_literal)
+			{
+				std::swap(clause[0], clause[1]);
+			}
+
+			// Si el otro literal vigilado es verdadero la clausula ya esta satisfecha
+			if (get_literal_value(clause[0]) == TRUE)
+			{
+				watches[j++] = watches[i++];
+				continue;
 			}
+
+			// Buscamos otro literal que no sea falso para vigilarlo
+			bool new_watch_found = false;
+			for (uint k = 2; k < clause.size(); ++k)
+			{
+				if (get_literal_value(clause[k]) != FALSE)
+				{
+					std::swap(clause[1], clause[k]);
+					watch_list(clause[1]).push_back(clause_ref);
+					new_watch_found = true;
+					break;
+				}
+			}
+
+			if (new_watch_found)
+			{
+				++i;
+				continue;
+			}
+
+			watches[j++] = watches[i++];
+
+			if (get_literal_value(clause[0]) == FALSE)
+			{
+				// Todos los literales son falsos, tenemos un conflicto.
+				// Antes de salir hay que conservar el resto de la lista.
+				while (i < watches.size())
+				{
+					watches[j++] = watches[i++];
+				}
+				watches.resize(j);
+
+				conflicting_clause = clause_ref;
+				update_activity_conflicting_clause(clause_ref);
+				return true;
+			}
+
+			// La clausula es unitaria, el otro literal vigilado tiene que ser verdadero
+			set_literal_to_true(clause[0], clause_ref);
 		}
+		watches.resize(j);
 	}
 	// Si llega aquí es por que no se ha encontrado un conflicto
 	return false;
 }
 
+/**
+ * @brief Propaga los literales en el modelo para identificar posibles conflictos.
+ *
+ * Delega en la implementación seleccionada con `PROPAGATION_MODE` y acumula en
+ * `propagation_allocations` las reservas de memoria hechas durante la propagación.
+ *
+ * @return `true` si se detecta un conflicto; `false` si no se encuentra ninguno.
+ */
+bool Solver::propagate_conflicts()
+{
+	uint64_t allocations_before = allocation_count();
+
+#if PROPAGATION_MODE == WATCHED_LITERALS
+	bool conflict = propagate_watched_literals();
+#else
+	bool conflict = propagate_occurrence_lists();
+#endif
+
+	statistics.propagation_allocations += allocation_count() - allocations_before;
+	return conflict;
+}
+
 /**
  * @brief Retrocede en el nivel de decisión y ajusta las decisiones tomadas.
  *
@@ -890,33 +1506,570 @@ bool propagate_conflicts()
  * - Actualiza la variable `index_of_next_literal_to_propagate` para reflejar el
  *   nuevo estado de la pila.
  *
- * @note Es importante que las variables globales `model_stack`, `model`,
- *       `decision_level`, y la función `set_literal_to_true` estén correctamente
- *       definidas antes de llamar a esta función.
+ * @note Es importante que las variables globales `model_stack`, `model`,
+ *       `decision_level`, y la función `set_literal_to_true` estén correctamente
+ *       definidas antes de llamar a esta función.
+ */
+void Solver::backtrack()
+{
+	// Si el camino que escogimos no funciono, hay que echar para atras
+	// eso es lo que hace esta función, olvida las decisiones que tomamos por el camino
+	// y cuando llega al inicio del camino que decidimos tomar, invierte el valor
+	// para que podamos seguir investigando.
+
+	uint i = model_stack.size() - 1;
+	int literal = 0;
+	while (model_stack[i] != DECISION_MARK)
+	{
+		literal = model_stack[i];
+		unassign(literal);
+		model_stack.pop_back();
+		--i;
+	}
+	model_stack.pop_back();
+	--decision_level;
+	index_of_next_literal_to_propagate = model_stack.size();
+	set_literal_to_true(-literal);
+}
+
+/**
+ * @brief Analiza el último conflicto y construye una cláusula aprendida 1-UIP.
+ *
+ * Partiendo de la cláusula conflictiva (`conflicting_clause`), resuelve hacia atrás
+ * con las cláusulas razón de los literales del nivel de decisión actual hasta que solo
+ * queda un literal de ese nivel (el primer punto de implicación único, 1-UIP).
+ *
+ * La cláusula aprendida queda en `learned_clause`. La posición 0 contiene la negación
+ * del 1-UIP y la posición 1 el literal con el nivel de decisión más alto del resto de
+ * la cláusula.
+ *
+ * @return El nivel de decisión al que hay que retroceder para que la cláusula aprendida
+ *         sea unitaria (0 si la cláusula tiene un solo literal).
+ *
+ * @details
+ * - Los literales asignados en el nivel 0 se descartan porque son siempre falsos.
+ * - Se eliminan los literales cuya razón queda cubierta por el resto de la cláusula.
+ * - Todos los literales que participan en el análisis aumentan su actividad (VSIDS).
+ */
+uint Solver::analyze_conflict()
+{
+	learned_clause.assign(1, 0);
+
+	ClauseRef reason = conflicting_clause;
+	int literal = 0;
+	int literals_in_current_level = 0;
+	uint i = model_stack.size();
+
+	do
+	{
+		if (clause_arena.is_learned(reason))
+		{
+			update_activity_clause(reason);
+		}
+
+		for (int reason_literal : clause_arena.clause(reason))
+		{
+			uint var = literal_var(reason_literal);
+			if (reason_literal == literal or seen[var] or variable_level[var] == 0)
+			{
+				continue;
+			}
+
+			seen[var] = true;
+			update_activity_literal(reason_literal);
+			if (variable_level[var] == decision_level)
+			{
+				++literals_in_current_level;
+			}
+			else
+			{
+				learned_clause.push_back(reason_literal);
+			}
+		}
+
+		// Buscamos en la pila el siguiente literal marcado del nivel actual
+		do
+		{
+			--i;
+		} while (model_stack[i] == DECISION_MARK or not seen[literal_var(model_stack[i])]);
+
+		literal = model_stack[i];
+		reason = variable_reason[literal_var(literal)];
+		seen[literal_var(literal)] = false;
+		--literals_in_current_level;
+	} while (literals_in_current_level > 0);
+
+	learned_clause[0] = -literal;
+
+	// Minimizamos la clausula: un literal sobra si todos los demas literales de su razon
+	// ya estan en la clausula (o son del nivel 0), porque resolver con esa razon lo elimina
+	removed_literals.clear();
+	uint kept = 1;
+	for (uint j = 1; j < learned_clause.size(); ++j)
+	{
+		ClauseRef literal_reason = variable_reason[literal_var(learned_clause[j])];
+		bool redundant = literal_reason != CLAUSE_REF_UNDEF;
+		if (redundant)
+		{
+			for (int reason_literal : clause_arena.clause(literal_reason))
+			{
+				uint var = literal_var(reason_literal);
+				if (var != literal_var(learned_clause[j]) and not seen[var] and variable_level[var] > 0)
+				{
+					redundant = false;
+					break;
+				}
+			}
+		}
+
+		if (redundant)
+		{
+			removed_literals.push_back(learned_clause[j]);
+		}
+		else
+		{
+			learned_clause[kept++] = learned_clause[j];
+		}
+	}
+	learned_clause.resize(kept);
+	for (int removed_literal : removed_literals)
+	{
+		seen[literal_var(removed_literal)] = false;
+	}
+
+	// Buscamos el nivel al que hay que retroceder y dejamos ese literal en la posicion 1
+	uint backjump_level = 0;
+	for (uint j = 1; j < learned_clause.size(); ++j)
+	{
+		seen[literal_var(learned_clause[j])] = false;
+
+		if (variable_level[literal_var(learned_clause[j])] > backjump_level)
+		{
+			backjump_level = variable_level[literal_var(learned_clause[j])];
+			std::swap(learned_clause[1], learned_clause[j]);
+		}
+	}
+
+	return backjump_level;
+}
+
+/**
+ * @brief Retrocede hasta un nivel de decisión dado, desasignando todo lo que está por encima.
+ *
+ * A diferencia de `backtrack`, no invierte ninguna decisión: solo deja la pila y el modelo
+ * como estaban al final del nivel `level`.
+ *
+ * @param level El nivel de decisión al que se quiere volver.
+ */
+void Solver::backjump(uint level)
+{
+	while (decision_level > level)
+	{
+		int literal = model_stack.back();
+		model_stack.pop_back();
+
+		if (literal == DECISION_MARK)
+		{
+			--decision_level;
+		}
+		else
+		{
+			unassign(literal);
+		}
+	}
+	index_of_next_literal_to_propagate = model_stack.size();
+}
+
+/**
+ * @brief Agrega una cláusula aprendida a la base de cláusulas.
+ *
+ * La cláusula `learned_clause` (con al menos dos literales) se guarda al final de
+ * `clause_arena`, su referencia en `learned_clauses` y se registra en las estructuras de
+ * propagación del modo activo con `attach_clause`.
+ *
+ * @param lbd El LBD de la cláusula, calculado antes de retroceder.
+ *
+ * @return La referencia a la cláusula guardada.
+ */
+ClauseRef Solver::add_learned_clause(uint lbd)
+{
+	ClauseRef clause_ref = clause_arena.allocate(learned_clause, true);
+	clause_arena.set_lbd(clause_ref, lbd);
+	clause_arena.set_activity(clause_ref, clause_activity_increment);
+	learned_clauses.push_back(clause_ref);
+	++statistics.learned_clauses;
+	attach_clause(clause_ref);
+
+	return clause_ref;
+}
+
+/**
+ * @brief Resuelve un conflicto aprendiendo una cláusula y retrocediendo de forma no cronológica.
+ *
+ * Analiza el conflicto, retrocede al nivel donde la cláusula aprendida es unitaria y
+ * asigna su literal 1-UIP usando la cláusula aprendida como razón, para que la siguiente
+ * llamada a `propagate_conflicts` continúe desde ahí.
+ */
+void Solver::learn_and_backjump()
+{
+	uint backjump_level = analyze_conflict();
+
+	++conflicts_since_restart;
+
+	// El LBD se calcula antes de retroceder, mientras los literales conservan su nivel
+	uint lbd = compute_lbd(learned_clause.data(), learned_clause.data() + learned_clause.size());
+	if (options.restart_policy == RESTART_GLUCOSE)
+	{
+		total_lbds_sum += lbd;
+		if (recent_lbds.size() < GLUCOSE_LBD_WINDOW)
+		{
+			recent_lbds.push_back(lbd);
+		}
+		else
+		{
+			recent_lbds_sum -= recent_lbds[recent_lbds_next];
+			recent_lbds[recent_lbds_next] = lbd;
+			recent_lbds_next = (recent_lbds_next + 1) % GLUCOSE_LBD_WINDOW;
+		}
+		recent_lbds_sum += lbd;
+	}
+
+	backjump(backjump_level);
+
+	if (clause_exchange != nullptr and learned_clause.size() <= 2)
+	{
+		clause_exchange->publish(exchange_id, learned_clause.data(), learned_clause.size());
+		++statistics.exported_clauses;
+	}
+
+	if (learned_clause.size() == 1)
+	{
+		// Las clausulas unitarias no hace falta guardarlas, el literal queda fijo en el nivel 0
+		set_literal_to_true(learned_clause[0]);
+	}
+	else
+	{
+		set_literal_to_true(learned_clause[0], add_learned_clause(lbd));
+	}
+}
+
+/**
+ * @brief Encuentra las suposiciones que obligan a que `assumption` sea falsa y las deja, junto con
+ *        `assumption`, en `failed_assumptions`.
+ *
+ * Recorre la pila hacia atrás desde la negación de `assumption` siguiendo las razones de las
+ * asignaciones, como `analyze_conflict`. Los literales sin razón por encima del nivel 0 son
+ * decisiones, y mientras se aplican las suposiciones todas las decisiones son suposiciones.
+ */
+void Solver::analyze_failed_assumption(int assumption)
+{
+	failed_assumptions.assign(1, assumption);
+	if (variable_level[literal_var(assumption)] == 0)
+	{
+		// La formula sola ya la hace falsa
+		return;
+	}
+
+	seen[literal_var(assumption)] = true;
+	for (uint i = model_stack.size(); i-- > 0;)
+	{
+		int literal = model_stack[i];
+		if (literal == DECISION_MARK or not seen[literal_var(literal)])
+		{
+			continue;
+		}
+		if (variable_level[literal_var(literal)] == 0)
+		{
+			break;
+		}
+
+		seen[literal_var(literal)] = false;
+		ClauseRef reason = variable_reason[literal_var(literal)];
+		if (reason == CLAUSE_REF_UNDEF)
+		{
+			failed_assumptions.push_back(literal);
+			continue;
+		}
+		for (int reason_literal : clause_arena.clause(reason))
+		{
+			if (reason_literal != literal and variable_level[literal_var(reason_literal)] > 0)
+			{
+				seen[literal_var(reason_literal)] = true;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Cuenta los niveles de decisión distintos de los literales entre `begin` y `end` (su LBD).
+ *
+ * Mientras menos niveles tiene una cláusula aprendida, más relacionados están sus literales y
+ * más útil suele ser para la propagación.
+ *
+ * @note Todos los literales deben estar asignados.
+ */
+uint Solver::compute_lbd(const int *begin, const int *end)
+{
+	++current_level_stamp;
+	uint lbd = 0;
+	for (const int *literal = begin; literal < end; ++literal)
+	{
+		uint level = variable_level[literal_var(*literal)];
+		if (level_stamp[level] != current_level_stamp)
+		{
+			level_stamp[level] = current_level_stamp;
+			++lbd;
+		}
+	}
+	return lbd;
+}
+
+/**
+ * @brief Calcula cuántos conflictos tienen que pasar hasta el siguiente reinicio, según la
+ *        política y la cantidad de reinicios hechos.
+ */
+void Solver::update_restart_limit()
+{
+	switch (options.restart_policy)
+	{
+	case RESTART_LUBY:
+		restart_limit = options.restart_interval * luby(2, solve_restarts);
+		break;
+	case RESTART_GEOMETRIC:
+		restart_limit = options.restart_interval * std::pow(RESTART_GEOMETRIC_FACTOR, solve_restarts);
+		break;
+	default:
+		// RESTART_GLUCOSE no tiene intervalos fijos y RESTART_NONE no reinicia
+		restart_limit = UINT64_MAX;
+		break;
+	}
+}
+
+/**
+ * @brief Indica si la búsqueda se debe reiniciar, según la política de `options`.
+ */
+bool Solver::should_restart()
+{
+	if (options.restart_policy == RESTART_GLUCOSE)
+	{
+		// Comparamos los promedios sin dividir: reciente * K > total  <=>  suma reciente * K * conflictos > suma total * ventana
+		return recent_lbds.size() == GLUCOSE_LBD_WINDOW and
+			   recent_lbds_sum * GLUCOSE_RESTART_K * statistics.conflicts > total_lbds_sum * GLUCOSE_LBD_WINDOW;
+	}
+	return conflicts_since_restart >= restart_limit;
+}
+
+/**
+ * @brief Reinicia la búsqueda: deshace todas las decisiones y vuelve al nivel 0.
+ *
+ * Las cláusulas aprendidas y las actividades se conservan, así que la búsqueda vuelve a empezar
+ * por las variables que más conflictos han causado, pero sin quedar atada a las primeras decisiones.
+ */
+void Solver::restart()
+{
+	backjump(0);
+	++statistics.restarts;
+	++solve_restarts;
+	conflicts_since_restart = 0;
+
+	// Con RESTART_GLUCOSE la ventana se vacia para que el siguiente reinicio mire solo conflictos nuevos
+	recent_lbds.clear();
+	recent_lbds_next = 0;
+	recent_lbds_sum = 0;
+
+	update_restart_limit();
+}
+
+/**
+ * @brief Indica si una cláusula es la razón de alguna asignación actual. Esas cláusulas no se
+ *        pueden borrar, las necesita el análisis de conflictos.
+ */
+bool Solver::is_locked(ClauseRef clause_ref)
+{
+	for (int literal : clause_arena.clause(clause_ref))
+	{
+		if (variable_reason[literal_var(literal)] == clause_ref and get_literal_value(literal) == TRUE)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Borra la mitad menos útil de las cláusulas aprendidas.
+ *
+ * Las cláusulas se ordenan de peor a mejor: primero por LBD (mayor es peor) y, con el mismo
+ * LBD, por actividad (menor es peor). Se borran las de la primera mitad, salvo las "glue"
+ * (LBD <= `LEARNED_GLUE_LBD`) y las que son razón de una asignación.
+ *
+ * @details
+ * - Las cláusulas borradas solo se marcan en el arena; si el espacio desperdiciado supera
+ *   `ARENA_WASTE_LIMIT`, se compacta con `compact_clause_arena`.
+ * - Las listas de propagación se reconstruyen sin las cláusulas borradas, así la propagación
+ *   no tiene que saltarlas.
+ * - La siguiente reducción se programa `REDUCE_INTERVAL_INCREMENT` conflictos más tarde que
+ *   si se repitiera el intervalo anterior.
+ */
+void Solver::reduce_learned_clauses()
+{
+	++statistics.reductions;
+	reduce_interval += REDUCE_INTERVAL_INCREMENT;
+	next_reduce = statistics.conflicts + reduce_interval;
+
+	std::sort(learned_clauses.begin(), learned_clauses.end(), [this](ClauseRef a, ClauseRef b) {
+		if (clause_arena.lbd(a) != clause_arena.lbd(b))
+		{
+			return clause_arena.lbd(a) > clause_arena.lbd(b);
+		}
+		return clause_arena.activity(a) < clause_arena.activity(b);
+	});
+
+	size_t half = learned_clauses.size() / 2;
+	size_t kept = 0;
+	for (size_t i = 0; i < learned_clauses.size(); ++i)
+	{
+		ClauseRef clause_ref = learned_clauses[i];
+		if (i < half and clause_arena.lbd(clause_ref) > LEARNED_GLUE_LBD and not is_locked(clause_ref))
+		{
+			for (int literal : clause_arena.clause(clause_ref))
+			{
+				--occurrences(literal);
+			}
+			clause_arena.mark_deleted(clause_ref);
+			++statistics.deleted_clauses;
+		}
+		else
+		{
+			learned_clauses[kept++] = clause_ref;
+		}
+	}
+	learned_clauses.resize(kept);
+
+	// En el orden del arena, para que al compactar las clausulas conserven su orden
+	std::sort(learned_clauses.begin(), learned_clauses.end());
+
+	if (clause_arena.wasted() > ARENA_WASTE_LIMIT * clause_arena.words())
+	{
+		compact_clause_arena();
+	}
+	rebuild_propagation_lists();
+}
+
+/**
+ * @brief Mueve las cláusulas vivas a un arena nuevo sin huecos y actualiza todas las referencias
+ *        (`clauses`, `learned_clauses` y las razones de las variables asignadas).
+ */
+void Solver::compact_clause_arena()
+{
+	++statistics.arena_compactions;
+
+	ClauseArena compacted;
+	compacted.reserve(clause_arena.words() - clause_arena.wasted());
+	for (ClauseRef &clause_ref : clauses)
+	{
+		clause_ref = clause_arena.relocate(clause_ref, compacted);
+	}
+	for (ClauseRef &clause_ref : learned_clauses)
+	{
+		clause_ref = clause_arena.relocate(clause_ref, compacted);
+	}
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+		// Las razones nunca estan borradas (ver is_locked), asi que ya se movieron
+		if (variable_reason[var] != CLAUSE_REF_UNDEF)
+		{
+			variable_reason[var] = clause_arena.relocate(variable_reason[var], compacted);
+		}
+	}
+
+	clause_arena = std::move(compacted);
+	conflicting_clause = CLAUSE_REF_UNDEF;
+}
+
+/**
+ * @brief Vuelve a llenar las listas de propagación y las cantidades de apariciones con las
+ *        cláusulas de `clauses` y `learned_clauses`.
+ *
+ * Las listas conservan su capacidad, así que no se pide memoria. En modo `WATCHED_LITERALS`
+ * cada cláusula vuelve a vigilar sus dos primeros literales, que son los que vigilaba.
+ */
+void Solver::rebuild_propagation_lists()
+{
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+		positive_clauses[var].clear();
+		negative_clauses[var].clear();
+		positive_watches[var].clear();
+		negative_watches[var].clear();
+		positive_occurrences[var] = 0;
+		negative_occurrences[var] = 0;
+	}
+
+	for (ClauseRef clause_ref : clauses)
+	{
+		attach_clause(clause_ref);
+	}
+	for (ClauseRef clause_ref : learned_clauses)
+	{
+		attach_clause(clause_ref);
+	}
+}
+
+/**
+ * @brief Agrega las cláusulas unitarias y binarias que publicaron otros solvers en `clause_exchange`.
+ *
+ * Solo se llama en el nivel 0, donde todos los valores son definitivos: las cláusulas ya
+ * satisfechas se descartan, las unitarias (o binarias con un literal falso) asignan su literal y
+ * las demás binarias se guardan como aprendidas (con LBD 2, así que nunca se borran).
+ *
+ * @return `false` si una cláusula recibida es falsa, es decir, si la fórmula es insatisfacible.
  */
-void backtrack()
+bool Solver::import_shared_clauses()
 {
-	// Si el camino que escogimos no funciono, hay que echar para atras
-	// eso es lo que hace esta función, olvida las decisiones que tomamos por el camino
-	// y cuando llega al inicio del camino que decidimos tomar, invierte el valor
-	// para que podamos seguir investigando.
-
-	uint i = model_stack.size() - 1;
-	int literal = 0;
-	while (model_stack[i] != DECISION_MARK)
+	int literals[2];
+	uint32_t size;
+	while (clause_exchange->read(exchange_id, exchange_positions, literals, size))
 	{
-		literal = model_stack[i];
-		model[literal_var(literal)] = UNASSIGNED;
-		model_stack.pop_back();
-		--i;
+		++statistics.imported_clauses;
+
+		int unassigned[2];
+		uint num_unassigned = 0;
+		bool satisfied = false;
+		for (uint32_t k = 0; k < size; ++k)
+		{
+			int value = get_literal_value(literals[k]);
+			if (value == TRUE)
+			{
+				satisfied = true;
+			}
+			else if (value == UNASSIGNED)
+			{
+				unassigned[num_unassigned++] = literals[k];
+			}
+		}
+
+		if (satisfied)
+		{
+			continue;
+		}
+		if (num_unassigned == 0)
+		{
+			return false;
+		}
+		if (num_unassigned == 1)
+		{
+			set_literal_to_true(unassigned[0]);
+		}
+		else
+		{
+			learned_clause.assign(literals, literals + 2);
+			add_learned_clause(2);
+		}
 	}
-	model_stack.pop_back();
-	--decision_level;
-	index_of_next_literal_to_propagate = model_stack.size();
-	set_literal_to_true(-literal);
+	return true;
 }
 
-
  /**
  * @brief Selecciona el siguiente literal para tomar como decisión heurística.
  *
@@ -926,49 +2079,77 @@ void backtrack()
  * @return El literal con mayor actividad que aún no ha sido asignado.
  *
  * @details
- * - Recorre todas las variables en el modelo para determinar cuál literal tiene 
- *   la mayor actividad, evaluando tanto su actividad positiva como negativa.
+ * - Saca variables de `decision_heap` (en O(log n) cada una) hasta encontrar una sin
+ *   asignar; las asignadas se vuelven a insertar cuando `backtrack` o `backjump` las liberan.
+ * - El signo del literal lo elige `choose_polarity` según `options.polarity`.
  * - Incrementa el contador de decisiones (`decisions`) para reflejar el número 
  *   de decisiones tomadas en el proceso de resolución.
  *
  * @note Es necesario que las variables globales `positive_literal_activity`, 
- *       `negative_literal_activity`, `model`, `num_variables` y la constante 
+ *       `negative_literal_activity`, `model`, `decision_heap` y la constante 
  *       `UNASSIGNED` estén correctamente configuradas antes de usar esta función.
  *
- * @todo Esta función creo que puede ser un poco costosa por que pasa por todas las variables
- * por lo que si no funciona para los sudokus lo que podemos hacer es revisar al azar, tipo tomar
- * 100 o 200 literales y revisar, y tomar el que tenga la mayor actividad.
- *
  */
-int get_next_decision_literal()
+int Solver::get_next_decision_literal()
 {
 	// Aquí se escoge el siguiente literal a tomar como decision
 	// en este caso se escoge el que tenga la mayor actividad
 	// Esta es la heuristica que se utiliza para decidir que literal.
 
 	// esto tambien es algo que no importa mucho, si no se lo voy a mostrar al usuario lo puedo eliminar
-	++decisions;
+	++statistics.decisions;
 
-	double maximum_activity = 0.0;
-	int most_active_literal = 0;
-	for (uint i = 1; i <= num_variables; ++i)
+	while (not decision_heap.empty())
 	{
-		if (model[i] == UNASSIGNED)
+		int var = decision_heap.pop_max();
+		if (model[var] == UNASSIGNED)
 		{
-			if (positive_literal_activity[i] >= maximum_activity)
-			{
-				maximum_activity = positive_literal_activity[i];
-				most_active_literal = i;
-			}
-			else if (negative_literal_activity[i] >= maximum_activity)
-			{
-				maximum_activity = negative_literal_activity[i];
-				most_active_literal = -i;
-			}
+			return choose_polarity(var);
 		}
 	}
 
-	return most_active_literal;
+	// Todas las variables estan asignadas
+	return 0;
+}
+
+/**
+ * @brief Elige el signo con el que se decide una variable, según `options.polarity`.
+ *
+ * @param var La variable que se va a decidir.
+ *
+ * @return `var` o `-var`.
+ *
+ * @details
+ * - Con `POLARITY_SAVED` se repite el último valor de la variable: después de un retroceso o de
+ *   un reinicio la búsqueda vuelve rápido a la asignación parcial que tenía, sin volver a
+ *   encontrar los mismos conflictos.
+ * - Los números al azar se generan con xorshift64, que guarda todo su estado en `random_state`
+ *   y así se copia junto con el solver.
+ */
+int Solver::choose_polarity(uint var)
+{
+	switch (options.polarity)
+	{
+	case POLARITY_SAVED:
+		if (saved_phase[var] != UNASSIGNED)
+		{
+			return saved_phase[var] == TRUE ? var : -var;
+		}
+		break;
+	case POLARITY_FALSE:
+		return -var;
+	case POLARITY_TRUE:
+		return var;
+	case POLARITY_RANDOM:
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 7;
+		random_state ^= random_state << 17;
+		return (random_state & 1) ? var : -var;
+	default:
+		break;
+	}
+
+	return positive_literal_activity[var] >= negative_literal_activity[var] ? var : -var;
 }
 
 /**
@@ -986,28 +2167,51 @@ int get_next_decision_literal()
  * - El programa muestra los literales de la cláusula que causa el error y se 
  *   termina inmediatamente usando `exit(1)`.
  *
- * @note Es necesario que las variables globales `clauses`, `num_clauses` y la función 
- *       `get_literal_value` estén correctamente inicializadas antes de llamar a esta función.
+ * @note Solo se revisan las cláusulas originales (`clauses`, u `original_formula` si se preprocesó la
+ *       fórmula), las aprendidas son consecuencia de ellas.
  */
-void check_model()
+void Solver::check_model()
 {
-	for (uint i = 0; i < num_clauses; ++i)
-	{
+	auto check_clause = [this](const int *begin, const int *end) {
 		bool some_true = false;
-		for (uint j = 0; not some_true and j < clauses[i].size(); ++j)
+		for (const int *literal = begin; not some_true and literal < end; ++literal)
 		{
-			some_true = (get_literal_value(clauses[i][j]) == TRUE);
+			some_true = (get_literal_value(*literal) == TRUE);
 		}
 		if (not some_true)
 		{
 			std::cout << "Error en el modelo, la clausula no es satisfecha:";
-			for (uint j = 0; j < clauses[i].size(); ++j)
+			for (const int *literal = begin; literal < end; ++literal)
 			{
-				std::cout << clauses[i][j] << " ";
+				std::cout << *literal << " ";
 			}
 			std::cout << std::endl;
 			exit(1);
 		}
+	};
+
+	if (preprocessed)
+	{
+		// Las clausulas de `clauses` son las simplificadas, el modelo debe satisfacer las originales
+		const int *clause_begin = original_formula.literals.data();
+		const int *formula_end = clause_begin + original_formula.literals.size();
+		while (clause_begin < formula_end)
+		{
+			const int *clause_end = clause_begin;
+			while (*clause_end != 0)
+			{
+				++clause_end;
+			}
+			check_clause(clause_begin, clause_end);
+			clause_begin = clause_end + 1;
+		}
+		return;
+	}
+
+	for (ClauseRef clause_ref : clauses)
+	{
+		Clause clause = clause_arena.clause(clause_ref);
+		check_clause(clause.begin(), clause.end());
 	}
 }
 /**
@@ -1033,10 +2237,16 @@ void check_model()
  *
  */
 
-bool exit_with_satisfiability(bool satisfiable)
+bool Solver::exit_with_satisfiability(bool satisfiable)
 {
+	result = satisfiable ? RESULT_SAT : RESULT_UNSAT;
 	if (satisfiable)
 	{
+		if (preprocessed)
+		{
+			// Las variables eliminadas no tienen valor en la busqueda, se les da uno que satisfaga sus clausulas
+			preprocessor.extend_model(model);
+		}
 		check_model();
 		// std::cout << "SATISFACIBLE,"s << decisions << "," << propagations << std::endl;
 		return true;
@@ -1048,6 +2258,47 @@ bool exit_with_satisfiability(bool satisfiable)
 	}
 }
 
+const char *result_name(int result)
+{
+	if (result == RESULT_SAT)
+	{
+		return "SAT";
+	}
+	return result == RESULT_UNSAT ? "UNSAT" : "UNKNOWN";
+}
+
+void print_solver_statistics(const SolverStatistics &statistics, std::ostream &out)
+{
+	out << "Decisions: " << statistics.decisions << std::endl;
+	out << "Propagations: " << statistics.propagations << std::endl;
+	out << "Conflicts: " << statistics.conflicts << std::endl;
+	out << "Learned clauses: " << statistics.learned_clauses << std::endl;
+	out << "Restarts: " << statistics.restarts << std::endl;
+	out << "Decision levels: " << statistics.max_decision_level << " max, "
+		<< (statistics.conflicts > 0 ? double(statistics.conflict_level_sum) / statistics.conflicts : 0.0)
+		<< " average at conflicts" << std::endl;
+	if (statistics.exported_clauses > 0 or statistics.imported_clauses > 0)
+	{
+		out << "Shared clauses: " << statistics.exported_clauses << " exported, " << statistics.imported_clauses
+			<< " imported" << std::endl;
+	}
+	out << "Deleted clauses: " << statistics.deleted_clauses << " in " << statistics.reductions << " reductions, "
+		<< statistics.arena_compactions << " arena compactions" << std::endl;
+	out << "Propagation allocations: " << statistics.propagation_allocations << std::endl;
+	out << "Parse: " << statistics.parse.bytes << " bytes in " << statistics.parse.seconds << " seconds ("
+		<< statistics.parse.megabytes_per_second() << " MB/s)" << std::endl;
+
+	const PreprocessStatistics &preprocess = statistics.preprocess;
+	if (preprocess.clauses_before > 0)
+	{
+		out << "Preprocess: " << preprocess.clauses_before << " -> " << preprocess.clauses_after << " clauses, "
+			<< preprocess.fixed_variables << " fixed and " << preprocess.eliminated_variables
+			<< " eliminated variables, " << preprocess.subsumed_clauses << " subsumed, "
+			<< preprocess.strengthened_clauses << " strengthened and " << preprocess.removed_clauses
+			<< " duplicate or tautological clauses, " << preprocess.seconds << " seconds" << std::endl;
+	}
+}
+
 /**
  * @brief Ejecuta el algoritmo DPLL para determinar la satisfacibilidad del problema.
  *
@@ -1062,10 +2313,18 @@ bool exit_with_satisfiability(bool satisfiable)
  * - Durante cada iteración, intenta propagar los literales para detectar conflictos.
  * - Si la propagación identifica un conflicto y no hay niveles de decisión restantes, 
  *   se considera el problema como insatisfacible.
+ * - En modo `CDCL` los conflictos se resuelven con `learn_and_backjump`; en modo
+ *   `CHRONOLOGICAL_BACKTRACKING` se invierte la última decisión con `backtrack`.
+ * - Después de resolver los conflictos, en modo `CDCL` se reduce la base de cláusulas aprendidas
+ *   cada cierta cantidad de conflictos y se reinicia la búsqueda si la política de
+ *   `options.restart_policy` lo indica.
  * - Si no se detectan conflictos y no quedan literales para decidir, el problema se 
  *   considera satisfacible.
  * - En caso de que haya literales para decidir, se toma una nueva decisión y se 
  *   continúa el proceso.
+ * - En el nivel 0 se agregan las cláusulas recibidas de otros solvers (`clause_exchange`), y
+ *   antes de cada decisión se revisa si otro hilo pidió detener la búsqueda (`stop_flag`) y si
+ *   se alcanzó alguno de los límites de `options` (`check_limits`).
  *
  * @note Requiere que las funciones `propagate_conflicts`, `backtrack`, `get_next_decision_literal`, 
  *       `exit_with_satisfiability` y `set_literal_to_true`, así como las variables globales 
@@ -1073,7 +2332,7 @@ bool exit_with_satisfiability(bool satisfiable)
  *       estén correctamente configuradas antes de llamar a esta función.
  *
  */
-bool execute_DPLL()
+bool Solver::execute_DPLL()
 {
 	while (true)
 	{
@@ -1082,23 +2341,170 @@ bool execute_DPLL()
 			if (decision_level == 0)
 			{
 				// No hay más decisiones posibles, lo que significa que el problema es insatisfacible
+				empty_clause_added = true;
+				return exit_with_satisfiability(false);
+			}
+#if SEARCH_MODE == CDCL
+			learn_and_backjump();
+#else
+			if (decision_level <= assumptions.size())
+			{
+				// Las dos ramas de las decisiones posteriores fallaron: las suposiciones hasta este
+				// nivel no tienen modelo (sin clausulas aprendidas no se puede reducir mas)
+				failed_assumptions.assign(assumptions.begin(), assumptions.begin() + decision_level);
 				return exit_with_satisfiability(false);
 			}
 			backtrack();
+#endif
+		}
+
+#if SEARCH_MODE == CDCL
+		if (options.reduce_interval > 0 and statistics.conflicts >= next_reduce)
+		{
+			reduce_learned_clauses();
+		}
+
+		// Sin aprendizaje un reinicio perderia las decisiones ya invertidas, asi que solo se reinicia en modo CDCL
+		if (decision_level > 0 and should_restart())
+		{
+			restart();
+		}
+
+		if (decision_level == 0 and clause_exchange != nullptr)
+		{
+			if (not import_shared_clauses())
+			{
+				empty_clause_added = true;
+				return exit_with_satisfiability(false);
+			}
+			if (index_of_next_literal_to_propagate < model_stack.size())
+			{
+				// Hay literales recibidos que propagar antes de decidir
+				continue;
+			}
+		}
+#endif
+
+		if (monitor != nullptr)
+		{
+			monitor->poll(*this);
+		}
+
+		if (stop_flag != nullptr and stop_flag->load(std::memory_order_relaxed))
+		{
+			return stop_search("interrupted");
+		}
+
+		if (has_limits)
+		{
+			const char *reason = check_limits();
+			if (reason != nullptr)
+			{
+				return stop_search(reason);
+			}
+		}
+
+		// Las primeras decisiones son las suposiciones, en orden
+		int decision_literal = 0;
+		while (decision_literal == 0 and decision_level < assumptions.size())
+		{
+			int assumption = assumptions[decision_level];
+			int value = get_literal_value(assumption);
+			if (value == FALSE)
+			{
+				analyze_failed_assumption(assumption);
+				return exit_with_satisfiability(false);
+			}
+			if (value == UNASSIGNED)
+			{
+				decision_literal = assumption;
+			}
+			else
+			{
+				// Ya es verdadera: un nivel vacio mantiene la suposicion i en el nivel i + 1
+				model_stack.push_back(DECISION_MARK);
+				++index_of_next_literal_to_propagate;
+				++decision_level;
+			}
 		}
 
-		int decision_literal = get_next_decision_literal();
+		if (decision_literal == 0)
+		{
+			decision_literal = get_next_decision_literal();
+		}
 		if (decision_literal == 0)
 		{
 			return exit_with_satisfiability(true);
 		}
 
-		// Aquí es donde ya tomamos una nueva decision
-		model_stack.push_back(DECISION_MARK); // agregar marca indicando una nueva decision
-		++index_of_next_literal_to_propagate;
-		++decision_level;
-		set_literal_to_true(decision_literal); // ahora agregar el primer literal
+		decide(decision_literal);
+	}
+}
+
+/**
+ * @brief Revisa los límites de `options` para la llamada a `solve` en curso.
+ *
+ * Los contadores se comparan en cada llamada; el reloj y la memoria del proceso cuestan más, así
+ * que solo se miran una vez cada `LIMIT_CHECK_PERIOD` llamadas.
+ *
+ * @return El nombre del límite alcanzado, o `nullptr` si no se alcanzó ninguno.
+ */
+const char *Solver::check_limits()
+{
+	if (options.conflict_limit > 0 and statistics.conflicts - solve_start_conflicts >= options.conflict_limit)
+	{
+		return "conflict limit";
+	}
+	if (options.propagation_limit > 0 and
+		statistics.propagations - solve_start_propagations >= options.propagation_limit)
+	{
+		return "propagation limit";
+	}
+
+	if (--limit_check_countdown > 0)
+	{
+		return nullptr;
 	}
+	limit_check_countdown = LIMIT_CHECK_PERIOD;
+
+	if (options.time_limit > 0)
+	{
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - solve_start_time;
+		if (elapsed.count() >= options.time_limit)
+		{
+			return "time limit";
+		}
+	}
+	if (options.memory_limit > 0 and current_memory_bytes() >= options.memory_limit * 1048576)
+	{
+		return "memory limit";
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Termina la búsqueda sin respuesta. Lo aprendido se conserva para la siguiente llamada a `solve`.
+ *
+ * @return `false`, lo que devuelve `solve`.
+ */
+bool Solver::stop_search(const char *reason)
+{
+	stopped = true;
+	result = RESULT_UNKNOWN;
+	statistics.stop_reason = reason;
+	return false;
+}
+
+/**
+ * @brief Abre un nuevo nivel de decisión y asigna `literal` como la decisión de ese nivel.
+ */
+void Solver::decide(int literal)
+{
+	model_stack.push_back(DECISION_MARK); // agregar marca indicando una nueva decision
+	++index_of_next_literal_to_propagate;
+	++decision_level;
+	statistics.max_decision_level = std::max<uint64_t>(statistics.max_decision_level, decision_level);
+	set_literal_to_true(literal); // ahora agregar el primer literal
 }
 
 /**
@@ -1106,7 +2512,7 @@ bool execute_DPLL()
  *
  * Esta función recorre todas las cláusulas del modelo en busca de aquellas que 
  * son unitarias (es decir, que contienen solo un literal). Si encuentra una cláusula 
- * unitaria que es falsa, determina que el modelo es insatisfacible y finaliza el programa. 
+ * unitaria que es falsa, determina que el modelo es insatisfacible. 
  * Si encuentra una cláusula unitaria con un literal no asignado, asigna dicho literal 
  * como verdadero.
  *
@@ -1117,18 +2523,15 @@ bool execute_DPLL()
  * - Esta verificación asegura que el modelo cumpla las restricciones de las cláusulas 
  *   unitarias antes de proceder con la resolución.
  *
- * @note Requiere que las variables globales `clauses`, `num_clauses` y las funciones 
- *       `get_literal_value`, `set_literal_to_true` y `exit_with_satisfiability` estén 
- *       correctamente definidas y configuradas antes de llamar a esta función.
- *
+ * @return `false` si alguna cláusula unitaria es falsa, `true` en caso contrario.
  */
-void check_unit_clauses()
+bool Solver::check_unit_clauses()
 {
-	for (uint i = 0; i < num_clauses; ++i)
+	for (ClauseRef clause_ref : clauses)
 	{
-		if (clauses[i].size() == 1)
+		if (clause_arena.size(clause_ref) == 1)
 		{
-			int literal = clauses[i][0];
+			int literal = clause_arena.clause(clause_ref)[0];
 			int value = get_literal_value(literal);
 			if (value == FALSE)
 			{
@@ -1136,7 +2539,7 @@ void check_unit_clauses()
 				// no hay que buscar mas, esto significa que por algun lugar esta
 				// el mismo literal pero con el signo cambiado lo que hace
 				// que la expresion siempre sea falsa
-				exit_with_satisfiability(false);
+				return false;
 			}
 			else if (value == UNASSIGNED)
 			{
@@ -1144,19 +2547,231 @@ void check_unit_clauses()
 			}
 		}
 	}
+	return true;
+}
+
+/**
+ * @brief Simplifica las cláusulas originales con `Preprocessor` y reconstruye con el resultado
+ *        todas las estructuras de propagación.
+ *
+ * Las cláusulas originales se copian en `original_formula` para que `check_model` valide el
+ * modelo contra ellas. Las variables eliminadas salen de `decision_heap`: no aparecen en ninguna
+ * cláusula, su valor lo decide `Preprocessor::extend_model` al final.
+ *
+ * @note Se debe llamar antes de asignar cualquier variable.
+ *
+ * @return `false` si el preprocesamiento demostró que la fórmula es insatisfacible.
+ */
+bool Solver::preprocess()
+{
+	original_formula.num_variables = num_variables;
+	for (ClauseRef clause_ref : clauses)
+	{
+		Clause clause = clause_arena.clause(clause_ref);
+		preprocessor.add_clause(clause.begin(), clause.size());
+		for (int literal : clause)
+		{
+			original_formula.add_literal(literal);
+		}
+		original_formula.end_clause();
+	}
+
+	CnfFormula simplified;
+	bool satisfiable = preprocessor.simplify(simplified);
+	statistics.preprocess = preprocessor.get_statistics();
+
+	clause_arena.clear();
+	clauses.clear();
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+		positive_clauses[var].clear();
+		negative_clauses[var].clear();
+		positive_watches[var].clear();
+		negative_watches[var].clear();
+		positive_occurrences[var] = 0;
+		negative_occurrences[var] = 0;
+	}
+
+	decision_heap.clear();
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+		if (not preprocessor.is_eliminated(var))
+		{
+			decision_heap.insert(var);
+		}
+	}
+
+	// Se marca al final porque add_formula agrega las clausulas simplificadas con add_clause, que
+	// despues de preprocesar tambien las guardaria en original_formula
+	satisfiable = satisfiable and add_formula(simplified);
+	preprocessed = true;
+	return satisfiable;
+}
+
+/**
+ * @brief Asigna `literal` en un nivel de decisión nuevo, lo propaga y deshace todo.
+ *
+ * @return La cantidad de literales que quedaron asignados (incluido `literal`), o -1 si la
+ *         propagación encontró un conflicto.
+ */
+int Solver::probe_literal(int literal)
+{
+	size_t stack_size = model_stack.size();
+	model_stack.push_back(DECISION_MARK);
+	++index_of_next_literal_to_propagate;
+	++decision_level;
+	set_literal_to_true(literal);
+
+	bool conflict = propagate_conflicts();
+	int assigned = model_stack.size() - stack_size - 1;
+
+	backjump(decision_level - 1);
+	return conflict ? -1 : assigned;
+}
+
+int Solver::choose_lookahead_variable()
+{
+	if (empty_clause_added or not check_unit_clauses() or propagate_conflicts())
+	{
+		return 0;
+	}
+
+	std::vector<std::pair<uint, uint>> candidates;
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+		if (model[var] == UNASSIGNED and positive_occurrences[var] + negative_occurrences[var] > 0)
+		{
+			candidates.push_back({positive_occurrences[var] + negative_occurrences[var], var});
+		}
+	}
+	size_t num_candidates = std::min<size_t>(LOOKAHEAD_CANDIDATES, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + num_candidates, candidates.end(),
+					  std::greater<std::pair<uint, uint>>());
+
+	int best_var = 0;
+	double best_score = -1;
+	for (size_t k = 0; k < num_candidates; ++k)
+	{
+		int var = candidates[k].second;
+		int positive = probe_literal(var);
+		int negative = probe_literal(-var);
+
+		// Una rama con conflicto se refuta enseguida, asi que cuenta como si asignara todo
+		double positive_score = positive < 0 ? num_variables : positive;
+		double negative_score = negative < 0 ? num_variables : negative;
+		double score = (positive_score + 1) * (negative_score + 1);
+		if (score > best_score)
+		{
+			best_score = score;
+			best_var = var;
+		}
+	}
+	return best_var;
+}
+
+void Solver::freeze_variable(uint var)
+{
+	grow_variables(var);
+	preprocessor.freeze(var);
+}
+
+bool Solver::simplify_formula()
+{
+	if (not empty_clause_added and options.preprocess and not preprocessed and not preprocess())
+	{
+		empty_clause_added = true;
+	}
+	return not empty_clause_added;
+}
+
+bool Solver::solve(const std::vector<int> &assumptions)
+{
+	stopped = false;
+	result = RESULT_UNKNOWN;
+	statistics.stop_reason.clear();
+	failed_assumptions.clear();
+
+	// Los limites cuentan desde aqui, asi que incluyen el preprocesamiento
+	has_limits = options.time_limit > 0 or options.conflict_limit > 0 or options.propagation_limit > 0 or
+				 options.memory_limit > 0;
+	solve_start_time = std::chrono::steady_clock::now();
+	solve_start_conflicts = statistics.conflicts;
+	solve_start_propagations = statistics.propagations;
+	limit_check_countdown = 1;
+
+	// Se deshace la busqueda anterior; lo aprendido en ella se conserva, pero los reinicios y las
+	// reducciones vuelven a empezar su calendario, si no tras varias llamadas casi no habria reinicios
+	backjump(0);
+	solve_restarts = 0;
+	conflicts_since_restart = 0;
+	update_restart_limit();
+	reduce_interval = options.reduce_interval;
+	next_reduce = statistics.conflicts + options.reduce_interval;
+	this->assumptions = assumptions;
+	for (int assumption : assumptions)
+	{
+		if (preprocessed and preprocessor.is_eliminated(literal_var(assumption)))
+		{
+			throw std::runtime_error("Error: La variable " + std::to_string(literal_var(assumption)) +
+									 " fue eliminada al preprocesar la formula");
+		}
+		grow_variables(literal_var(assumption));
+		if (options.preprocess and not preprocessed)
+		{
+			preprocessor.freeze(literal_var(assumption));
+		}
+	}
+
+	// Cada suposicion que ya es verdadera ocupa un nivel de decision vacio, asi que puede haber
+	// tantos niveles (y marcas en la pila) como variables mas suposiciones
+	if (level_stamp.size() < num_variables + assumptions.size() + 1)
+	{
+		level_stamp.resize(num_variables + assumptions.size() + 1, 0);
+	}
+
+	// Copiar un solver (por ejemplo el solver base de los sudokus o de los cubos) no conserva la
+	// capacidad reservada de los vectores, asi que se vuelve a reservar antes de propagar
+	model_stack.reserve(2 * num_variables + assumptions.size() + 1);
+#if PROPAGATION_MODE == WATCHED_LITERALS
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+		positive_watches[var].reserve(positive_occurrences[var]);
+		negative_watches[var].reserve(negative_occurrences[var]);
+	}
+#endif
+
+	if (not simplify_formula() or not check_unit_clauses())
+	{
+		// La formula es insatisfacible sin importar las suposiciones; las llamadas siguientes no buscan mas
+		empty_clause_added = true;
+		return exit_with_satisfiability(false);
+	}
+
+	return execute_DPLL();
+}
+
+std::map<int, bool> Solver::get_model() const
+{
+	std::map<int, bool> model_map;
+	for (uint i = 1; i <= num_variables; ++i)
+	{
+		if (model[i] != UNASSIGNED)
+		{
+			model_map[i] = (model[i] == TRUE);
+		}
+	}
+	return model_map;
 }
 
 bool main_test(const std::string &file_path)
 {
 	// Read the problem file (available at the stdin stream) and
 	//  initialize the rest of necessary variables
-	parse_DIMACS_input(file_path);
+	Solver solver;
+	parse_DIMACS_input(file_path, solver);
 
-	// Take care of initial unit clauses, if any
-	check_unit_clauses();
-
-	// Execute the main DPLL procedure
-	return execute_DPLL();
+	// Take care of initial unit clauses, if any, and execute the main DPLL procedure
+	return solver.solve();
 }
 
 
@@ -1169,23 +2784,26 @@ bool main_test(const std::string &file_path)
  *
  * @param dimacs_file_path Ruta al archivo DIMACS que contiene la representación 
  *                         del problema de satisfacibilidad.
+ * @param statistics Si no es nulo, recibe las estadísticas de la búsqueda (solo en la tercera versión).
+ * @param options Las opciones de la búsqueda (solo en la tercera versión).
  *
  * @return Un par (`std::pair`) que contiene:
- *         - Un valor booleano que indica si el problema es satisfacible (`true`) 
- *           o insatisfacible (`false`).
+ *         - El resultado: `RESULT_SAT`, `RESULT_UNSAT` o `RESULT_UNKNOWN` si la búsqueda alcanzó
+ *           un límite de `options` o se interrumpió (las versiones 1 y 2 no tienen límites).
  *         - Un mapa (`std::map<int, bool>`) que representa el modelo resultante 
  *           de asignaciones de literales si el problema es satisfacible.
  *
  * @details
- * - Si el archivo DIMACS no puede abrirse, se imprime un mensaje de error y se 
- *   devuelve un par vacío con un resultado `false`.
+ * - Si el archivo DIMACS no puede abrirse o `VERSION` no es válida, se lanza
+ *   `std::runtime_error` (un resultado `RESULT_UNSAT` se confundiría con una respuesta).
  *
  * @note Las funciones auxiliares como `parse_DIMACS_to_clauses`, `check_unit_clauses`, 
  *       y `execute_DPLL`, así como las variables globales necesarias, deben estar 
  *       correctamente definidas antes de usar esta función.
  * 
  */
-std::pair<bool, std::map<int, bool>> dpll_solver(std::string dimacs_file_path)
+std::pair<int, std::map<int, bool>> dpll_solver(std::string dimacs_file_path, SolverStatistics *statistics,
+												const SolverOptions &options, SolverMonitor *monitor)
 {
 
 	std::cout << "Solving " << dimacs_file_path << std::endl;
@@ -1195,8 +2813,7 @@ std::pair<bool, std::map<int, bool>> dpll_solver(std::string dimacs_file_path)
 		std::ifstream file(dimacs_file_path);
 		if (!file)
 		{
-			std::cerr << "Error: Could not open file " << dimacs_file_path << std::endl;
-			return {false, {}};
+			throw std::runtime_error("Error: No se puede abrir el archivo: " + dimacs_file_path);
 		}
 
 		std::string dimacs_clauses((std::istreambuf_iterator<char>(file)),
@@ -1221,8 +2838,7 @@ std::pair<bool, std::map<int, bool>> dpll_solver(std::string dimacs_file_path)
 		std::ifstream file(dimacs_file_path);
 		if (!file)
 		{
-			std::cerr << "Error: Could not open file " << dimacs_file_path << std::endl;
-			return {false, {}};
+			throw std::runtime_error("Error: No se puede abrir el archivo: " + dimacs_file_path);
 		}
 
 		std::string dimacs_clauses((std::istreambuf_iterator<char>(file)),
@@ -1239,27 +2855,28 @@ std::pair<bool, std::map<int, bool>> dpll_solver(std::string dimacs_file_path)
 	}
 	else if (VERSION == 3)
 	{
-		parse_DIMACS_input(dimacs_file_path);
-
-		// Take care of initial unit clauses, if any
-		check_unit_clauses();
+		Solver solver(options);
+		if (monitor != nullptr)
+		{
+			monitor->attach(solver);
+		}
+		ParseStatistics parse_statistics = parse_DIMACS_input(dimacs_file_path, solver);
+		if (monitor != nullptr)
+		{
+			monitor->set_parse_statistics(parse_statistics);
+		}
 
-		// Execute the main DPLL procedure
-		bool result = execute_DPLL();
+		solver.solve();
 
-		std::map<int, bool> model_map;
-		for (uint i = 1; i <= num_variables; ++i)
+		if (statistics != nullptr)
 		{
-			if (model[i] != UNASSIGNED)
-			{
-				model_map[i] = (model[i] == TRUE);
-			}
+			*statistics = solver.get_statistics();
+			statistics->parse = parse_statistics;
 		}
-		return {result, model_map};
+		return {solver.get_result(), solver.get_model()};
 	}
 	else
 	{
-		std::cerr << "Error: Version no valida" << std::endl;
-		return {false, {}};
+		throw std::runtime_error("Error: Version no valida");
 	}
 }
@@ -1,31 +1,205 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <thread>
 #include "include/dpllSolver.h"
+#include "include/batchSolver.h"
+#include "include/portfolioSolver.h"
+#include "include/cubeSolver.h"
+#include "include/solverMonitor.h"
+
+/**
+ * @brief Modo por lotes: `--batch <carpeta|lista> [-j N] [--format csv|json] [opciones del solver]`.
+ *
+ * @return El código de salida del programa.
+ */
+int batch_main(int argc, char *argv[])
+{
+	std::string batch_path;
+	uint num_threads = std::max(1u, std::thread::hardware_concurrency());
+	int format = BATCH_FORMAT_CSV;
+	SolverOptions options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--batch" && i + 1 < argc)
+		{
+			batch_path = argv[++i];
+		}
+		else if (arg == "-j" && i + 1 < argc)
+		{
+			num_threads = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--format" && i + 1 < argc && std::string(argv[i + 1]) == "csv")
+		{
+			format = BATCH_FORMAT_CSV;
+			++i;
+		}
+		else if (arg == "--format" && i + 1 < argc && std::string(argv[i + 1]) == "json")
+		{
+			format = BATCH_FORMAT_JSON;
+			++i;
+		}
+		else if (parse_solver_option(argc, argv, i, options))
+		{
+			continue;
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " --batch <dir|list_file> [-j N] [--format csv|json] [solver options]" << std::endl;
+			print_solver_options_usage(std::cerr);
+			return 1;
+		}
+	}
+
+	try
+	{
+		std::vector<std::string> instances = collect_batch_instances(batch_path);
+		solve_batch(instances, num_threads, format, options, std::cout);
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
 
 int main(int argc, char *argv[])
 {
-	if (argc != 2)
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == "--batch")
+		{
+			return batch_main(argc, argv);
+		}
+	}
+
+	bool show_statistics = false;
+	SolverOptions options;
+	std::string dimacs_file_path;
+	// --portfolio N resuelve con N solvers en paralelo; 0 usa un solo solver en este hilo
+	uint portfolio_size = 0;
+	bool share_clauses = true;
+	// --cubes N divide la busqueda en cubos que resuelven N hilos
+	uint cube_workers = 0;
+	// --progress S imprime una linea de progreso cada S segundos (solo con un solver)
+	double progress_interval = 0;
+	std::string stats_json_path;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--stats")
+		{
+			show_statistics = true;
+		}
+		else if (arg == "--portfolio" && i + 1 < argc)
+		{
+			portfolio_size = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--cubes" && i + 1 < argc)
+		{
+			cube_workers = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--no-share")
+		{
+			share_clauses = false;
+		}
+		else if (arg == "--progress" && i + 1 < argc)
+		{
+			progress_interval = std::max(0.0, std::atof(argv[++i]));
+		}
+		else if (arg == "--stats-json" && i + 1 < argc)
+		{
+			stats_json_path = argv[++i];
+		}
+		else if (parse_solver_option(argc, argv, i, options))
+		{
+			continue;
+		}
+		else if (dimacs_file_path.empty() && (arg == "-" || arg[0] != '-'))
+		{
+			dimacs_file_path = arg;
+		}
+		else
+		{
+			dimacs_file_path.clear();
+			break;
+		}
+	}
+
+	// Las lineas de progreso y los volcados leen un solo solver, asi que no hay con varios hilos
+	if (dimacs_file_path.empty() || (portfolio_size > 0 && cube_workers > 0) ||
+		(progress_interval > 0 && (portfolio_size > 0 || cube_workers > 0)))
 	{
-		std::cerr << "Usage: " << argv[0] << " <sudoku_file_path>" << std::endl;
+		std::cerr << "Usage: " << argv[0] << " [--stats] [--stats-json FILE] [--progress S | --portfolio N [--no-share] | --cubes N] [solver options] <dimacs_file_path>" << std::endl;
+		std::cerr << "       " << argv[0] << " --batch <dir|list_file> [-j N] [--format csv|json] [solver options]" << std::endl;
+		print_solver_options_usage(std::cerr);
 		return 1;
 	}
 
 	bool show_results = false;
 
-	std::string dimacs_file_path = argv[1];
-
 	// Start measuring time
 	auto start_time = std::chrono::high_resolution_clock::now();
 
-	auto [result, model] = dpll_solver(dimacs_file_path);
+	SolverStatistics statistics;
+	int result;
+	std::map<int, bool> model;
+	PortfolioResult portfolio_result;
+	CubeResult cube_result;
+	SolverMonitor monitor(std::cerr, progress_interval);
+	monitor.install_signal_handlers();
+	try
+	{
+		if (cube_workers > 0)
+		{
+			std::cout << "Solving " << dimacs_file_path << " with cubes on " << cube_workers << " threads" << std::endl;
+			cube_result = solve_cubes(dimacs_file_path, cube_workers, options, monitor.interrupt_flag());
+			result = cube_result.stopped ? RESULT_UNKNOWN : (cube_result.satisfiable ? RESULT_SAT : RESULT_UNSAT);
+			model = cube_result.model;
+			statistics = cube_result.statistics;
+		}
+		else if (portfolio_size > 0)
+		{
+			std::cout << "Solving " << dimacs_file_path << " with " << portfolio_size << " solvers" << std::endl;
+			portfolio_result = solve_portfolio(dimacs_file_path, portfolio_size, options, share_clauses,
+											   monitor.interrupt_flag());
+			result = portfolio_result.stopped ? RESULT_UNKNOWN
+											  : (portfolio_result.satisfiable ? RESULT_SAT : RESULT_UNSAT);
+			model = portfolio_result.model;
+			statistics = portfolio_result.statistics;
+		}
+		else
+		{
+			std::tie(result, model) = dpll_solver(dimacs_file_path, &statistics, options, &monitor);
+		}
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	// Stop measuring time
 	auto end_time = std::chrono::high_resolution_clock::now();
 	std::chrono::duration<double> elapsed_time = end_time - start_time;
 
 	// Output the result
-	if (result)
+	std::string status = result_name(result);
+	if (monitor.was_interrupted())
+	{
+		status = "INTERRUPTED";
+		std::cout << "INTERRUPTED" << std::endl;
+	}
+	else if (result == RESULT_UNKNOWN)
+	{
+		std::cout << "UNKNOWN (" << statistics.stop_reason << ")" << std::endl;
+	}
+	else if (result == RESULT_SAT)
 	{
 		std::cout << "SATISFIABLE" << std::endl;
 	}
@@ -37,7 +211,41 @@ int main(int argc, char *argv[])
 	// Output the elapsed time
 	std::cout << "Time: " << elapsed_time.count() << " seconds" << std::endl;
 
-	if (show_results && result)
+	if (portfolio_size > 0 && !portfolio_result.stopped)
+	{
+		std::cout << "Winner: solver " << portfolio_result.winner << " ("
+				  << describe_solver_options(portfolio_result.winner_options) << ")" << std::endl;
+	}
+	if (cube_workers > 0)
+	{
+		std::cout << "Cubes: " << cube_result.initial_cubes << " initial, " << cube_result.dynamic_splits
+				  << " dynamic splits, " << cube_result.refuted_cubes << " refuted" << std::endl;
+	}
+
+	// Al interrumpir con SIGINT o alcanzar un limite se muestra siempre lo que llevaba la busqueda
+	if (show_statistics || monitor.was_interrupted() || result == RESULT_UNKNOWN)
+	{
+		print_solver_statistics(statistics, std::cout);
+		std::cout << "Memory: peak " << peak_memory_bytes() / 1048576.0 << " MB" << std::endl;
+	}
+
+	if (!stats_json_path.empty())
+	{
+		std::ofstream json_file(stats_json_path);
+		if (!json_file)
+		{
+			std::cerr << "Cannot write " << stats_json_path << std::endl;
+			return 1;
+		}
+		write_solver_statistics_json(statistics, status, elapsed_time.count(), json_file);
+	}
+
+	if (monitor.was_interrupted())
+	{
+		return 130;
+	}
+
+	if (show_results && result == RESULT_SAT)
 	{
 		char user_input;
 		std::cout << "¿Desea ver los valores de las variables? (s/n): ";
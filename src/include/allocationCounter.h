@@ -0,0 +1,18 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+#include <cstdint>
+
+/**
+ * @brief Devuelve la cantidad de llamadas a `operator new` hechas por el hilo actual.
+ *
+ * El programa reemplaza los `operator new` globales para llevar esta cuenta. Sirve para medir
+ * si un fragmento de código reserva memoria: basta con comparar el valor antes y después.
+ *
+ * @note Ejemplo de uso:
+ *       uint64_t before = allocation_count();
+ *       propagate_conflicts();
+ *       uint64_t allocations = allocation_count() - before;
+ */
+uint64_t allocation_count();
+
+#endif // !ALLOCATION_COUNTER_H
@@ -0,0 +1,75 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+#include <vector>
+#include <string>
+#include <iostream>
+#include "dpllSolver.h"
+
+/**
+ * Formatos de salida del modo por lotes.
+ */
+#define BATCH_FORMAT_CSV 1
+#define BATCH_FORMAT_JSON 2
+
+/**
+ * @brief Resultado de resolver una instancia en el modo por lotes.
+ */
+struct BatchResult
+{
+	std::string instance;
+
+	/**
+	 * `SAT`, `UNSAT`, `UNKNOWN` (si se alcanzó un límite de las opciones) o `ERROR` (si el archivo
+	 * no se pudo abrir o no es un DIMACS válido).
+	 */
+	std::string status;
+
+	/**
+	 * Con `ERROR`, el mensaje de la excepción que explica el error; vacío en otro caso.
+	 */
+	std::string error;
+
+	double seconds = 0.0;
+
+	SolverStatistics statistics;
+};
+
+/**
+ * @brief Obtiene la lista de instancias a resolver en el modo por lotes.
+ *
+ * @param path Una carpeta, de la que se toman todos los archivos `.cnf`, `.cnf.gz` y `.cnf.xz`
+ *             en orden alfabético, o un archivo de texto con la ruta de una instancia por línea
+ *             (las líneas vacías y las que empiezan con `#` se ignoran).
+ *
+ * @return Las rutas de las instancias.
+ *
+ * @throws std::runtime_error Si `path` no existe o no se puede leer.
+ */
+std::vector<std::string> collect_batch_instances(const std::string &path);
+
+/**
+ * @brief Resuelve una lista de instancias con un grupo de hilos.
+ *
+ * Los hilos comparten una cola de trabajo: cada uno toma la siguiente instancia pendiente
+ * cuando termina la anterior, así que las instancias difíciles no bloquean a las demás.
+ * Cada instancia se resuelve con su propio `Solver`, por lo que los hilos no comparten estado
+ * de búsqueda.
+ *
+ * @param instances Las rutas de las instancias.
+ * @param num_threads La cantidad de hilos (al menos 1).
+ * @param format `BATCH_FORMAT_CSV` o `BATCH_FORMAT_JSON`.
+ * @param options Las opciones con las que se crea el `Solver` de cada instancia.
+ * @param out El flujo donde se escribe una línea por instancia a medida que se resuelven.
+ *
+ * @return Los resultados en el mismo orden que `instances`.
+ *
+ * @note En formato CSV la primera línea es el encabezado
+ *       `instance,status,seconds,decisions,propagations,conflicts,restarts,error`, donde `error` solo
+ *       tiene valor en las instancias con `ERROR`. En formato JSON cada línea es un objeto
+ *       independiente (JSON Lines), para poder procesar la salida mientras se genera, y el campo
+ *       `error` solo aparece en las instancias con `ERROR`.
+ */
+std::vector<BatchResult> solve_batch(const std::vector<std::string> &instances, uint num_threads, int format,
+									 const SolverOptions &options, std::ostream &out);
+
+#endif // !BATCH_SOLVER_H
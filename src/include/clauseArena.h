@@ -0,0 +1,258 @@
+#ifndef CLAUSE_ARENA_H
+#define CLAUSE_ARENA_H
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Referencia a una cláusula: es la posición (en palabras de 32 bits) de su encabezado dentro del arena.
+ */
+typedef uint32_t ClauseRef;
+
+/**
+ * Referencia que no apunta a ninguna cláusula (por ejemplo la razón de una decisión).
+ */
+const ClauseRef CLAUSE_REF_UNDEF = UINT32_MAX;
+
+/**
+ * @brief Vista sobre los literales de una cláusula guardada en un `ClauseArena`.
+ *
+ * No es dueña de la memoria, solo apunta a los literales dentro del arena. Deja de ser válida
+ * si el arena crece (al agregar cláusulas), por lo que no se debe guardar.
+ */
+class Clause
+{
+public:
+	Clause(int *literals, uint32_t size) : literals(literals), literal_count(size)
+	{
+	}
+
+	uint32_t size() const
+	{
+		return literal_count;
+	}
+
+	int &operator[](uint32_t i)
+	{
+		return literals[i];
+	}
+
+	int operator[](uint32_t i) const
+	{
+		return literals[i];
+	}
+
+	int *begin() const
+	{
+		return literals;
+	}
+
+	int *end() const
+	{
+		return literals + literal_count;
+	}
+
+private:
+	int *literals;
+	uint32_t literal_count;
+};
+
+/**
+ * @brief Almacén contiguo de cláusulas.
+ *
+ * Todas las cláusulas se guardan una detrás de otra en un único vector de palabras de 32 bits.
+ * Cada cláusula ocupa una palabra de encabezado seguida de sus literales:
+ *
+ *     | tamaño << 3 | banderas | literal 1 | literal 2 | ... | literal n |
+ *
+ * Las banderas indican si la cláusula es aprendida, si fue borrada y si fue movida a otro arena.
+ * Las cláusulas aprendidas tienen además dos palabras antes del encabezado, con su LBD y su
+ * actividad, así que leer los literales cuesta lo mismo para todas las cláusulas:
+ *
+ *     | LBD | actividad | tamaño << 3 | banderas | literal 1 | ... | literal n |
+ *
+ * Las cláusulas se referencian con la posición de su encabezado (`ClauseRef`), que a diferencia
+ * de un puntero sigue siendo válida cuando el vector crece.
+ *
+ * @note Ejemplo de uso:
+ *       ClauseArena arena;
+ *       ClauseRef ref = arena.allocate({1, -3, 2}, false);
+ *       arena.size(ref);      // 3
+ *       arena.clause(ref)[1]; // -3
+ */
+class ClauseArena
+{
+public:
+	/**
+	 * @brief Guarda una cláusula al final del arena.
+	 *
+	 * @param literals Los literales de la cláusula.
+	 * @param size La cantidad de literales.
+	 * @param learned Si la cláusula fue aprendida en un conflicto.
+	 *
+	 * @return La referencia a la nueva cláusula.
+	 */
+	ClauseRef allocate(const int *literals, uint32_t size, bool learned)
+	{
+		if (learned)
+		{
+			data.push_back(0);
+			data.push_back(0);
+		}
+		ClauseRef ref = data.size();
+		data.push_back(static_cast<int>((size << FLAG_BITS) | (learned ? LEARNED_FLAG : 0)));
+		data.insert(data.end(), literals, literals + size);
+		return ref;
+	}
+
+	ClauseRef allocate(const std::vector<int> &literals, bool learned)
+	{
+		return allocate(literals.data(), literals.size(), learned);
+	}
+
+	uint32_t size(ClauseRef ref) const
+	{
+		return header(ref) >> FLAG_BITS;
+	}
+
+	bool is_learned(ClauseRef ref) const
+	{
+		return header(ref) & LEARNED_FLAG;
+	}
+
+	bool is_deleted(ClauseRef ref) const
+	{
+		return header(ref) & DELETED_FLAG;
+	}
+
+	/**
+	 * @brief Marca una cláusula como borrada. Su espacio se cuenta como desperdiciado.
+	 */
+	void mark_deleted(ClauseRef ref)
+	{
+		if (not is_deleted(ref))
+		{
+			data[ref] = static_cast<int>(header(ref) | DELETED_FLAG);
+			wasted_words += size(ref) + 1 + (is_learned(ref) ? LEARNED_EXTRA_WORDS : 0);
+		}
+	}
+
+	/**
+	 * @brief LBD de una cláusula aprendida: la cantidad de niveles de decisión distintos de sus
+	 *        literales. Mientras menor, más útil suele ser la cláusula.
+	 */
+	uint32_t lbd(ClauseRef ref) const
+	{
+		return static_cast<uint32_t>(data[ref - 2]);
+	}
+
+	void set_lbd(ClauseRef ref, uint32_t lbd)
+	{
+		data[ref - 2] = static_cast<int>(lbd);
+	}
+
+	/**
+	 * @brief Actividad de una cláusula aprendida: crece cada vez que participa en un conflicto.
+	 */
+	float activity(ClauseRef ref) const
+	{
+		float activity;
+		memcpy(&activity, &data[ref - 1], sizeof(activity));
+		return activity;
+	}
+
+	void set_activity(ClauseRef ref, float activity)
+	{
+		memcpy(&data[ref - 1], &activity, sizeof(activity));
+	}
+
+	/**
+	 * @brief Copia una cláusula al final de `to` y devuelve su referencia allí.
+	 *
+	 * Sirve para compactar: se mueven a un arena nuevo las cláusulas que siguen vivas y el nuevo
+	 * reemplaza a este. La cláusula queda marcada como movida y guarda su nueva referencia, así
+	 * que moverla otra vez (por ejemplo desde la razón de una variable) devuelve la misma.
+	 */
+	ClauseRef relocate(ClauseRef ref, ClauseArena &to)
+	{
+		if (header(ref) & RELOCATED_FLAG)
+		{
+			return static_cast<ClauseRef>(data[ref + 1]);
+		}
+
+		Clause old_clause = clause(ref);
+		ClauseRef new_ref = to.allocate(old_clause.begin(), old_clause.size(), is_learned(ref));
+		if (is_learned(ref))
+		{
+			to.set_lbd(new_ref, lbd(ref));
+			to.set_activity(new_ref, activity(ref));
+		}
+
+		data[ref] = static_cast<int>(header(ref) | RELOCATED_FLAG);
+		data[ref + 1] = static_cast<int>(new_ref);
+		return new_ref;
+	}
+
+	/**
+	 * @brief Devuelve una vista sobre los literales de la cláusula.
+	 */
+	Clause clause(ClauseRef ref)
+	{
+		return Clause(&data[ref + 1], size(ref));
+	}
+
+	/**
+	 * @brief Reserva espacio para `words` palabras (encabezados más literales).
+	 */
+	void reserve(uint32_t words)
+	{
+		data.reserve(words);
+	}
+
+	/**
+	 * @brief Cantidad de palabras usadas, incluyendo las de cláusulas borradas.
+	 */
+	uint32_t words() const
+	{
+		return data.size();
+	}
+
+	/**
+	 * @brief Cantidad de palabras que ocupan las cláusulas borradas.
+	 */
+	uint32_t wasted() const
+	{
+		return wasted_words;
+	}
+
+	void clear()
+	{
+		data.clear();
+		wasted_words = 0;
+	}
+
+private:
+	static const uint32_t FLAG_BITS = 3;
+
+	static const uint32_t LEARNED_FLAG = 1;
+
+	static const uint32_t DELETED_FLAG = 2;
+
+	static const uint32_t RELOCATED_FLAG = 4;
+
+	/**
+	 * Palabras que las cláusulas aprendidas tienen antes del encabezado (LBD y actividad).
+	 */
+	static const uint32_t LEARNED_EXTRA_WORDS = 2;
+
+	uint32_t header(ClauseRef ref) const
+	{
+		return static_cast<uint32_t>(data[ref]);
+	}
+
+	std::vector<int> data;
+
+	uint32_t wasted_words = 0;
+};
+
+#endif // !CLAUSE_ARENA_H
@@ -0,0 +1,138 @@
+#ifndef CLAUSE_EXCHANGE_H
+#define CLAUSE_EXCHANGE_H
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Cantidad de cláusulas que guarda el buffer de cada solver. Si un solver lee más lento de lo que
+ * otro publica, pierde las cláusulas más viejas (compartir cláusulas es solo una ayuda).
+ */
+#define CLAUSE_EXCHANGE_CAPACITY 4096
+
+/**
+ * @brief Buffer sin bloqueos para compartir cláusulas unitarias y binarias entre solvers que
+ *        resuelven la misma fórmula en distintos hilos.
+ *
+ * Cada solver publica en su propio buffer circular (un solo escritor por buffer) y lee los de
+ * los demás, cada uno con su propia posición. Publicar nunca espera: el escritor sobrescribe las
+ * cláusulas más viejas. Quien lee detecta si una cláusula se sobrescribió mientras la copiaba
+ * (como en un seqlock) y en ese caso la descarta.
+ *
+ * @note Ejemplo de uso (el solver 0 publica, el 1 lee):
+ *       ClauseExchange exchange(2);
+ *       exchange.publish(0, literals, 2);
+ *       std::vector<uint64_t> positions(2, 0);
+ *       int read_literals[2];
+ *       uint32_t size;
+ *       while (exchange.read(1, positions, read_literals, size)) { ... }
+ */
+class ClauseExchange
+{
+public:
+	ClauseExchange(uint32_t num_solvers, uint32_t capacity = CLAUSE_EXCHANGE_CAPACITY)
+		: rings(new Ring[num_solvers]), num_rings(num_solvers), capacity(capacity)
+	{
+		for (uint32_t i = 0; i < num_rings; ++i)
+		{
+			rings[i].slots.reset(new Slot[capacity]);
+		}
+	}
+
+	uint32_t num_solvers() const
+	{
+		return num_rings;
+	}
+
+	/**
+	 * @brief Publica una cláusula de uno o dos literales. Solo la puede llamar el hilo del solver `source`.
+	 */
+	void publish(uint32_t source, const int *literals, uint32_t size)
+	{
+		Ring &ring = rings[source];
+		uint64_t head = ring.head.load(std::memory_order_relaxed);
+		Slot &slot = ring.slots[head % capacity];
+
+		// Los lectores que vean estos literales también verán que `head` ya pasó la posición
+		// anterior de la casilla, y sabrán que se sobrescribió
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.literals[0].store(literals[0], std::memory_order_relaxed);
+		slot.literals[1].store(size > 1 ? literals[1] : 0, std::memory_order_relaxed);
+		ring.head.store(head + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Lee la siguiente cláusula publicada por otro solver.
+	 *
+	 * @param reader El solver que lee; sus propias cláusulas se saltan.
+	 * @param positions La siguiente posición a leer del buffer de cada solver (empieza en 0). Es
+	 *                  propia de cada lector.
+	 * @param literals Recibe los literales de la cláusula.
+	 * @param size Recibe la cantidad de literales (1 o 2).
+	 *
+	 * @return `false` si no hay cláusulas nuevas.
+	 */
+	bool read(uint32_t reader, std::vector<uint64_t> &positions, int *literals, uint32_t &size) const
+	{
+		for (uint32_t source = 0; source < num_rings; ++source)
+		{
+			if (source == reader)
+			{
+				continue;
+			}
+
+			Ring &ring = rings[source];
+			uint64_t &position = positions[source];
+			uint64_t head = ring.head.load(std::memory_order_acquire);
+			while (position < head)
+			{
+				if (head - position > capacity)
+				{
+					// Quedamos atras por mas de una vuelta, las mas viejas ya se perdieron
+					position = head - capacity;
+				}
+
+				const Slot &slot = ring.slots[position % capacity];
+				literals[0] = slot.literals[0].load(std::memory_order_relaxed);
+				literals[1] = slot.literals[1].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				head = ring.head.load(std::memory_order_relaxed);
+
+				// Si el escritor ya llego a esta casilla en la vuelta siguiente, la copia puede estar mezclada
+				bool overwritten = head - position >= capacity;
+				++position;
+				if (not overwritten)
+				{
+					size = literals[1] == 0 ? 1 : 2;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<int> literals[2] = {0, 0};
+	};
+
+	struct Ring
+	{
+		std::unique_ptr<Slot[]> slots;
+
+		/**
+		 * Cantidad de cláusulas publicadas desde el principio (no se reinicia al dar la vuelta).
+		 */
+		std::atomic<uint64_t> head{0};
+	};
+
+	std::unique_ptr<Ring[]> rings;
+
+	uint32_t num_rings;
+
+	uint64_t capacity;
+};
+
+#endif // !CLAUSE_EXCHANGE_H
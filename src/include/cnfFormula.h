@@ -0,0 +1,70 @@
+#ifndef CNF_FORMULA_H
+#define CNF_FORMULA_H
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Fórmula en forma normal conjuntiva guardada de forma plana.
+ *
+ * Las cláusulas se guardan una detrás de otra en un único vector de literales, cada una
+ * terminada en 0 (igual que en el formato DIMACS). Es la representación intermedia entre
+ * quien genera las cláusulas (el parser de DIMACS, el codificador de sudokus) y el `Solver`,
+ * que con `Solver::add_formula` puede reservar de una vez todo el espacio que necesita.
+ *
+ * @note Ejemplo de uso:
+ *       CnfFormula formula;
+ *       formula.add_clause({1, -3});
+ *       formula.add_clause({2, 3, -1});
+ *       // formula.literals == {1, -3, 0, 2, 3, -1, 0}
+ */
+struct CnfFormula
+{
+	/**
+	 * La mayor variable de la fórmula.
+	 */
+	unsigned int num_variables = 0;
+
+	unsigned int num_clauses = 0;
+
+	/**
+	 * Los literales de todas las cláusulas, cada cláusula terminada en 0.
+	 */
+	std::vector<int> literals;
+
+	void add_literal(int literal)
+	{
+		unsigned int var = literal > 0 ? literal : -literal;
+		if (var > num_variables)
+		{
+			num_variables = var;
+		}
+		literals.push_back(literal);
+	}
+
+	/**
+	 * @brief Cierra la cláusula formada por los literales agregados desde el último 0.
+	 */
+	void end_clause()
+	{
+		literals.push_back(0);
+		++num_clauses;
+	}
+
+	void add_clause(const std::vector<int> &clause)
+	{
+		for (int literal : clause)
+		{
+			add_literal(literal);
+		}
+		end_clause();
+	}
+
+	void clear()
+	{
+		num_variables = 0;
+		num_clauses = 0;
+		literals.clear();
+	}
+};
+
+#endif // !CNF_FORMULA_H
@@ -0,0 +1,92 @@
+#ifndef CUBE_SOLVER_H
+#define CUBE_SOLVER_H
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include "dpllSolver.h"
+
+/**
+ * Cantidad de cubos iniciales por hilo. Con varios cubos por hilo el trabajo se reparte bien
+ * aunque algunos cubos sean mucho más difíciles que otros.
+ */
+#define CUBES_PER_WORKER 8
+
+/**
+ * Conflictos que un hilo busca en su cubo antes de aceptar dividirlo, para que los hilos sin
+ * trabajo no lo interrumpan una y otra vez al final de la búsqueda.
+ */
+#define MIN_SPLIT_CONFLICTS 1000
+
+/**
+ * @brief Resultado de resolver una fórmula con `solve_cubes`.
+ */
+struct CubeResult
+{
+	bool satisfiable = false;
+
+	/**
+	 * La búsqueda alcanzó un límite de `SolverOptions` o se interrumpió sin respuesta (la razón
+	 * queda en `statistics.stop_reason`).
+	 */
+	bool stopped = false;
+
+	/**
+	 * Cubos generados antes de empezar, divisiones hechas durante la búsqueda porque un hilo se
+	 * quedó sin trabajo, y cubos refutados.
+	 */
+	uint64_t initial_cubes = 0;
+
+	uint64_t dynamic_splits = 0;
+
+	uint64_t refuted_cubes = 0;
+
+	/**
+	 * La suma de las estadísticas de todos los solvers (el de cada cubo).
+	 */
+	SolverStatistics statistics;
+
+	/**
+	 * Un modelo de la fórmula, si es satisfacible.
+	 */
+	std::map<int, bool> model;
+};
+
+/**
+ * @brief Resuelve una fórmula dividiéndola en cubos que se reparten entre varios hilos
+ *        (cube-and-conquer).
+ *
+ * Un cubo es una asignación parcial; los cubos se eligen con `Solver::choose_lookahead_variable`
+ * y entre todos cubren el espacio de búsqueda. Cada cubo se resuelve con una copia de un solver
+ * base (que ya tiene la fórmula) al que se le agregan los literales del cubo como cláusulas unitarias.
+ * Con `options.preprocess`, la fórmula se preprocesa una sola vez en el solver base, antes de
+ * generar los cubos, así que los cubos solo usan variables que no se eliminaron.
+ *
+ * @details
+ * - Al principio se generan `CUBES_PER_WORKER` cubos por hilo, dividiendo siempre el cubo con
+ *   menos literales.
+ * - Cada hilo tiene su propia cola de cubos: toma el último que agregó y, si su cola está
+ *   vacía, le roba el más antiguo a otro hilo.
+ * - Si un hilo no encuentra cubos que robar, le pide a un hilo ocupado que divida su cubo: ese
+ *   hilo detiene su solver (con `Solver::set_stop_flag`), divide el cubo en dos, deja una mitad
+ *   en su cola y sigue con la otra en el mismo solver, agregándole el literal nuevo, así que
+ *   conserva lo aprendido. Un cubo solo se divide después de `MIN_SPLIT_CONFLICTS` conflictos.
+ * - La fórmula es satisfacible en cuanto un cubo lo es, y es insatisfacible solo cuando todos
+ *   los cubos quedaron refutados.
+ * - Los límites de `options` son de toda la búsqueda: cada cubo se resuelve con el tiempo, los
+ *   conflictos y las propagaciones que quedan, así que con varios hilos los contadores pueden
+ *   pasarse un poco. En cuanto un cubo alcanza un límite, la búsqueda termina sin respuesta.
+ *
+ * @param dimacs_file_path La fórmula, en el formato de `parse_DIMACS_file`.
+ * @param num_workers La cantidad de hilos (al menos 1).
+ * @param options Las opciones de los solvers.
+ * @param interrupt Si no es `nullptr`, el hilo que llama la revisa mientras espera y, cuando es
+ *                  verdadera, detiene la búsqueda sin respuesta (con `stopped`).
+ *
+ * @throws std::runtime_error Si el archivo no se puede leer. Si un hilo lanza una excepción, la
+ *         búsqueda termina y la excepción se vuelve a lanzar aquí.
+ */
+CubeResult solve_cubes(const std::string &dimacs_file_path, uint num_workers, const SolverOptions &options,
+					   const std::atomic<bool> *interrupt = nullptr);
+
+#endif // !CUBE_SOLVER_H
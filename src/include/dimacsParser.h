@@ -0,0 +1,121 @@
+#ifndef DIMACS_PARSER_H
+#define DIMACS_PARSER_H
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include "cnfFormula.h"
+
+/**
+ * @brief Cantidad de bytes leídos y tiempo que tomó parsear una entrada DIMACS.
+ */
+struct ParseStatistics
+{
+	uint64_t bytes = 0;
+
+	double seconds = 0.0;
+
+	double megabytes_per_second() const
+	{
+		return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+	}
+};
+
+/**
+ * @brief Parser de texto en formato DIMACS que recibe la entrada por fragmentos.
+ *
+ * Recorre el texto con un puntero y convierte los enteros a mano, sin pasar por `std::istream`.
+ * Los fragmentos pueden cortar una línea en cualquier punto: lo que queda después del último
+ * salto de línea se guarda y se procesa junto con el siguiente fragmento.
+ *
+ * Acepta:
+ * - Líneas de comentario que empiezan con `c`, en cualquier parte del archivo.
+ * - La línea de encabezado `p cnf <variables> <cláusulas>`. Los conteos no pueden ser negativos,
+ *   pero no se verifican contra las cláusulas: solo se usan para reservar memoria.
+ * - Cláusulas que ocupan varias líneas o varias cláusulas en una línea.
+ * - Un `%` que marca el final de la fórmula (como en los archivos de SATLIB); se ignora el resto.
+ * - Una última cláusula sin el 0 final.
+ *
+ * @note Ejemplo de uso:
+ *       CnfFormula formula;
+ *       DimacsParser parser(formula);
+ *       parser.parse(text, text + length);
+ *       parser.finish();
+ */
+class DimacsParser
+{
+public:
+	DimacsParser(CnfFormula &formula) : formula(formula)
+	{
+	}
+
+	/**
+	 * @brief Indica el tamaño de toda la entrada, si se conoce, para limitar lo que se reserva
+	 *        según el encabezado.
+	 */
+	void set_input_bytes(uint64_t bytes)
+	{
+		input_bytes = bytes;
+	}
+
+	/**
+	 * @brief Procesa un fragmento de la entrada.
+	 *
+	 * @throws std::runtime_error Si encuentra algo que no es un entero, un comentario o el encabezado.
+	 */
+	void parse(const char *begin, const char *end);
+
+	/**
+	 * @brief Procesa lo que quedó pendiente del último fragmento y cierra la última cláusula.
+	 */
+	void finish();
+
+private:
+	CnfFormula &formula;
+
+	/**
+	 * El final del último fragmento, desde su último salto de línea.
+	 */
+	std::string pending;
+
+	/**
+	 * Ya se encontró el `%` que marca el final de la fórmula.
+	 */
+	bool finished = false;
+
+	/**
+	 * Cantidad de literales de la cláusula que se está leyendo.
+	 */
+	unsigned int open_clause_size = 0;
+
+	/**
+	 * El tamaño de toda la entrada, o 0 si no se conoce.
+	 */
+	uint64_t input_bytes = 0;
+
+	void parse_lines(const char *begin, const char *end);
+};
+
+/**
+ * @brief Parsea un archivo DIMACS, comprimido o no.
+ *
+ * Según la ruta:
+ * - `-`: se lee la entrada estándar por fragmentos.
+ * - Termina en `.gz` o en `.xz`: se descomprime por fragmentos con zlib o liblzma. Cada fragmento
+ *   se parsea apenas se descomprime, sin escribir una copia descomprimida en disco.
+ * - Cualquier otra: el archivo se proyecta en memoria con `mmap` y se parsea sin copiarlo.
+ *
+ * @param file_path La ruta del archivo, o `-` para la entrada estándar.
+ * @param formula La fórmula donde se agregan las cláusulas.
+ *
+ * @return La cantidad de bytes de texto DIMACS (ya descomprimido) y el tiempo que tomó parsearlo.
+ *
+ * @throws std::runtime_error Si el archivo no se puede abrir o no cumple con el formato DIMACS.
+ */
+ParseStatistics parse_DIMACS_file(const std::string &file_path, CnfFormula &formula);
+
+/**
+ * @brief Escribe una fórmula en formato DIMACS: el encabezado `p cnf` y una cláusula por línea.
+ */
+void write_DIMACS(const CnfFormula &formula, std::ostream &out);
+
+#endif // !DIMACS_PARSER_H
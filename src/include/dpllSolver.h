@@ -1,6 +1,7 @@
 #ifndef DPLL_SOLVER_H
 #define DPLL_SOLVER_H
 #include <vector>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -8,8 +9,18 @@
 #include <map>
 #include <set>
 #include <csignal>
+#include <cstdint>
+#include <chrono>
+#include "clauseArena.h"
+#include "cnfFormula.h"
+#include "dimacsParser.h"
+#include "variableHeap.h"
+#include "preprocessor.h"
+#include "clauseExchange.h"
 // #define DEBUG
 
+class SolverMonitor;
+
 /**
  * @brief Convierte el contenido de un archivo en formato DIMACS a una representación interna de cláusulas y variables.
  *
@@ -44,6 +55,748 @@
  */
 std::tuple<std::vector<std::vector<int>>, std::set<int>>  parse_DIMACS_to_clauses(std::string dimacs);
 
+/**
+ * @brief Estadísticas de una ejecución de la tercera versión del solver.
+ */
+struct SolverStatistics
+{
+	uint64_t decisions = 0;
+
+	uint64_t propagations = 0;
+
+	uint64_t conflicts = 0;
+
+	uint64_t learned_clauses = 0;
+
+	uint64_t restarts = 0;
+
+	/**
+	 * El mayor nivel de decisión alcanzado y la suma de los niveles en los que hubo conflictos
+	 * (dividida entre `conflicts` da la profundidad promedio de los conflictos).
+	 */
+	uint64_t max_decision_level = 0;
+
+	uint64_t conflict_level_sum = 0;
+
+	/**
+	 * Cláusulas aprendidas borradas al reducir la base de cláusulas, cantidad de reducciones y
+	 * cantidad de veces que se compactó el arena.
+	 */
+	uint64_t deleted_clauses = 0;
+
+	uint64_t reductions = 0;
+
+	uint64_t arena_compactions = 0;
+
+	/**
+	 * Cláusulas unitarias y binarias enviadas a otros solvers y recibidas de ellos (ver `ClauseExchange`).
+	 */
+	uint64_t exported_clauses = 0;
+
+	uint64_t imported_clauses = 0;
+
+	/**
+	 * Cantidad de reservas de memoria hechas dentro de la propagación. Debería ser 0:
+	 * la propagación recorre las listas en su lugar y todo lo que crece se reserva de antemano.
+	 */
+	uint64_t propagation_allocations = 0;
+
+	/**
+	 * Tamaño de la entrada y tiempo de lectura. Los llenan `dpll_solver` y el modo por lotes.
+	 */
+	ParseStatistics parse;
+
+	/**
+	 * Lo que hizo el preprocesamiento (todo en 0 si no se preprocesó la fórmula).
+	 */
+	PreprocessStatistics preprocess;
+
+	/**
+	 * Por qué la última búsqueda terminó sin respuesta: `interrupted` (`Solver::set_stop_flag`),
+	 * `time limit`, `conflict limit`, `propagation limit` o `memory limit`. Vacío si hubo respuesta.
+	 */
+	std::string stop_reason;
+};
+
+/**
+ * Políticas de reinicio de la búsqueda (ver `SolverOptions::restart_policy`).
+ * - RESTART_NONE: nunca se reinicia.
+ * - RESTART_LUBY: se reinicia cada `restart_interval * luby(i)` conflictos (1, 1, 2, 1, 1, 2, 4, ...).
+ * - RESTART_GEOMETRIC: el intervalo empieza en `restart_interval` conflictos y crece de forma geométrica.
+ * - RESTART_GLUCOSE: se reinicia cuando las cláusulas aprendidas recientemente tienen un LBD
+ *   (cantidad de niveles de decisión distintos) mayor que el promedio de toda la búsqueda.
+ */
+#define RESTART_NONE 0
+
+#define RESTART_LUBY 1
+
+#define RESTART_GEOMETRIC 2
+
+#define RESTART_GLUCOSE 3
+
+/**
+ * Heurísticas para elegir el signo de una decisión (ver `SolverOptions::polarity`).
+ * - POLARITY_SAVED: el último valor que tuvo la variable antes de desasignarse (guardado de fase).
+ *   Las variables que nunca tuvieron valor usan POLARITY_ACTIVITY.
+ * - POLARITY_FALSE y POLARITY_TRUE: siempre el mismo valor.
+ * - POLARITY_RANDOM: un valor al azar.
+ * - POLARITY_ACTIVITY: el signo del literal con más actividad.
+ */
+#define POLARITY_SAVED 0
+
+#define POLARITY_FALSE 1
+
+#define POLARITY_TRUE 2
+
+#define POLARITY_RANDOM 3
+
+#define POLARITY_ACTIVITY 4
+
+/**
+ * Resultados de una llamada a `Solver::solve` (ver `Solver::get_result`).
+ * - RESULT_UNKNOWN: la búsqueda terminó sin respuesta, porque alcanzó uno de los límites de
+ *   `SolverOptions` o porque se detuvo con `Solver::set_stop_flag`.
+ */
+#define RESULT_UNSAT 0
+
+#define RESULT_SAT 1
+
+#define RESULT_UNKNOWN 2
+
+/**
+ * Cada cuántas decisiones se miran el reloj y la memoria para `SolverOptions::time_limit` y
+ * `SolverOptions::memory_limit`; los límites de conflictos y propagaciones se revisan en cada decisión.
+ */
+#define LIMIT_CHECK_PERIOD 64
+
+/**
+ * Cada cuántos milisegundos los modos con varios hilos (`solve_portfolio` y `solve_cubes`) revisan
+ * la bandera de interrupción que reciben.
+ */
+#define INTERRUPT_POLL_MS 10
+
+/**
+ * @brief Opciones de la búsqueda de la tercera versión del solver.
+ */
+struct SolverOptions
+{
+	int restart_policy = RESTART_GEOMETRIC;
+
+	/**
+	 * Conflictos del primer intervalo entre reinicios (la unidad de la sucesión de Luby).
+	 */
+	uint restart_interval = 100;
+
+	int polarity = POLARITY_ACTIVITY;
+
+	/**
+	 * Semilla de los números al azar de `POLARITY_RANDOM`.
+	 */
+	uint64_t random_seed = 1;
+
+	/**
+	 * Conflictos hasta la primera reducción de las cláusulas aprendidas; cada intervalo es
+	 * `REDUCE_INTERVAL_INCREMENT` conflictos más largo que el anterior. Con 0 nunca se borran.
+	 */
+	uint reduce_interval = 2000;
+
+	/**
+	 * Simplificar la fórmula con `Preprocessor` antes de la búsqueda.
+	 */
+	bool preprocess = false;
+
+	/**
+	 * Límites de cada llamada a `solve`: segundos, conflictos, propagaciones y megabytes de memoria
+	 * residente del proceso. Con 0 no hay límite. Al alcanzar uno, `solve` termina sin respuesta
+	 * (`Solver::get_result` devuelve `RESULT_UNKNOWN`).
+	 */
+	double time_limit = 0;
+
+	uint64_t conflict_limit = 0;
+
+	uint64_t propagation_limit = 0;
+
+	uint64_t memory_limit = 0;
+};
+
+/**
+ * @brief Tercera versión del solver DPLL (iterativa, con aprendizaje de cláusulas).
+ *
+ * Todo el estado de la búsqueda vive dentro de cada instancia, por lo que se pueden tener varios
+ * solvers a la vez (por ejemplo uno por hilo) y se pueden copiar. Una instancia no se debe usar
+ * desde dos hilos al mismo tiempo.
+ *
+ * El solver es incremental: después de `solve` se pueden agregar más cláusulas y volver a
+ * resolver, con o sin suposiciones. Las cláusulas aprendidas, las actividades y las fases guardadas
+ * se conservan entre llamadas, así que las consultas parecidas a las anteriores son rápidas.
+ *
+ * @note Ejemplo de uso:
+ *       Solver solver;
+ *       solver.add_clause({1, -3});
+ *       solver.add_clause({2, 3, -1});
+ *       if (solver.solve())
+ *       {
+ *           std::map<int, bool> model = solver.get_model();
+ *       }
+ *       if (not solver.solve({-1, 3}))
+ *       {
+ *           // Las suposiciones que causan la contradicción, aquí {3, -1}
+ *           std::vector<int> core = solver.get_failed_assumptions();
+ *       }
+ *       solver.add_clause({-1, 2});
+ *       solver.solve();
+ */
+class Solver
+{
+	/**
+	 * Los microbenchmarks (`solverBenchmarkMain.cpp`) llaman directamente a las funciones internas
+	 * de la búsqueda para medirlas por separado.
+	 */
+	friend class SolverBenchmark;
+
+public:
+	Solver(const SolverOptions &options = SolverOptions());
+
+	/**
+	 * @brief Reserva espacio para las variables `1..num_variables` y para `num_clauses` cláusulas.
+	 *
+	 * No es obligatorio llamarla: `add_clause` crea las variables que hagan falta, pero si se conoce
+	 * el tamaño del problema de antemano se evitan realocaciones.
+	 */
+	void reserve(uint num_variables, uint num_clauses);
+
+	/**
+	 * @brief Agrega una cláusula del problema.
+	 *
+	 * Se puede llamar también entre dos llamadas a `solve`: se deshace la asignación de la
+	 * búsqueda anterior (el modelo deja de ser válido) y se quitan de la cláusula los literales que
+	 * ya son falsos en el nivel 0.
+	 *
+	 * @param literals Los literales de la cláusula (enteros distintos de 0).
+	 *
+	 * @return `false` si la cláusula es vacía o queda vacía (la fórmula es insatisfacible), `true`
+	 *         en otro caso.
+	 *
+	 * @throws std::runtime_error Si la fórmula se preprocesó y la cláusula tiene una variable
+	 *         eliminada (ver `freeze_variable`).
+	 */
+	bool add_clause(const std::vector<int> &literals);
+
+	bool add_clause(const int *literals, uint size);
+
+	/**
+	 * @brief Agrega todas las cláusulas de una fórmula.
+	 *
+	 * Antes de agregarlas cuenta cuántas veces aparece cada literal, para reservar de una vez
+	 * el espacio exacto del arena y de las listas de propagación.
+	 *
+	 * @return `false` si alguna cláusula es vacía, `true` en otro caso.
+	 */
+	bool add_formula(const CnfFormula &formula);
+
+	/**
+	 * @brief Busca un modelo para las cláusulas agregadas en el que todas las suposiciones sean verdaderas.
+	 *
+	 * Las suposiciones solo valen para esta llamada: se toman como las primeras decisiones de la
+	 * búsqueda, así que todo lo aprendido sigue siendo válido sin ellas. Si no hay modelo,
+	 * `get_failed_assumptions` dice cuáles suposiciones bastan para la contradicción.
+	 *
+	 * Con `options.preprocess`, la fórmula se simplifica en la primera llamada (sin eliminar las
+	 * variables de las suposiciones); el modelo que se encuentra se completa con las variables
+	 * eliminadas, así que satisface las cláusulas agregadas.
+	 *
+	 * @param assumptions Literales que deben ser verdaderos en el modelo.
+	 *
+	 * @return `true` si la fórmula es satisfacible con las suposiciones, `false` si no lo es o si
+	 *         la búsqueda terminó sin respuesta (ver `get_result`).
+	 *
+	 * @throws std::runtime_error Si la fórmula se preprocesó y una suposición es de una variable eliminada.
+	 */
+	bool solve(const std::vector<int> &assumptions = std::vector<int>());
+
+	/**
+	 * @brief Devuelve las suposiciones de la última llamada a `solve` que bastan para que la
+	 *        fórmula sea insatisfacible (no necesariamente las mínimas).
+	 *
+	 * Está vacía si `solve` devolvió `true`, o si la fórmula es insatisfacible sin suposiciones.
+	 */
+	const std::vector<int> &get_failed_assumptions() const
+	{
+		return failed_assumptions;
+	}
+
+	/**
+	 * @brief Impide que el preprocesamiento elimine la variable `var`. Hace falta para las variables
+	 *        que van a aparecer en cláusulas agregadas o en suposiciones después del primer `solve`.
+	 */
+	void freeze_variable(uint var);
+
+	/**
+	 * @brief Simplifica la fórmula en este momento, si `options.preprocess` lo pide y no se hizo
+	 *        antes, en vez de esperar a la primera llamada a `solve`.
+	 *
+	 * Sirve para preprocesar una sola vez un solver que después se copia: las copias ya no vuelven
+	 * a preprocesar, y sus cláusulas nuevas solo pueden usar variables que no se eliminaron.
+	 *
+	 * @return `false` si la fórmula es insatisfacible, `true` en otro caso.
+	 */
+	bool simplify_formula();
+
+	/**
+	 * @brief Elige una variable para dividir la búsqueda en dos, con una heurística de anticipación
+	 *        (lookahead).
+	 *
+	 * Propaga las cláusulas unitarias y luego, para cada una de las variables sin asignar que
+	 * aparecen en más cláusulas, propaga por separado sus dos literales y cuenta cuántos literales
+	 * implica cada uno (un conflicto cuenta como todas las variables). Elige la variable con el
+	 * mayor producto de los dos conteos: la que más simplifica la fórmula en ambas ramas.
+	 *
+	 * @note Deja asignados en el nivel 0 los literales implicados por las cláusulas unitarias, así
+	 *       que se usa sobre una copia del solver que después se descarta.
+	 *
+	 * @return La variable elegida, o 0 si no hay variables sin asignar o si las cláusulas unitarias
+	 *         ya producen un conflicto.
+	 */
+	int choose_lookahead_variable();
+
+	/**
+	 * @brief Devuelve el valor de un literal en el modelo actual: 1 si es verdadero, 0 si es falso
+	 *        y -1 si su variable no tiene valor.
+	 */
+	int get_literal_value(int literal) const;
+
+	/**
+	 * @brief Devuelve las variables con valor en el modelo actual.
+	 */
+	std::map<int, bool> get_model() const;
+
+	uint get_num_variables() const
+	{
+		return num_variables;
+	}
+
+	/**
+	 * @brief Devuelven el nivel de decisión actual, la cantidad de literales asignados y la
+	 *        cantidad de cláusulas aprendidas que no se han borrado.
+	 */
+	uint get_decision_level() const
+	{
+		return decision_level;
+	}
+
+	uint64_t get_trail_size() const
+	{
+		return model_stack.size() - decision_level;
+	}
+
+	uint64_t get_num_learned_clauses() const
+	{
+		return learned_clauses.size();
+	}
+
+	const SolverStatistics &get_statistics() const
+	{
+		return statistics;
+	}
+
+	/**
+	 * @brief Permite detener la búsqueda desde otro hilo: `solve` revisa `stop` antes de cada
+	 *        decisión y, si es verdadero, termina devolviendo `false`.
+	 */
+	void set_stop_flag(const std::atomic<bool> *stop)
+	{
+		stop_flag = stop;
+	}
+
+	/**
+	 * @brief Indica si la última llamada a `solve` terminó sin una respuesta, por `set_stop_flag` o
+	 *        por un límite (la razón queda en `get_statistics().stop_reason`).
+	 */
+	bool was_stopped() const
+	{
+		return stopped;
+	}
+
+	/**
+	 * @brief Devuelve el resultado de la última llamada a `solve`: `RESULT_SAT`, `RESULT_UNSAT` o
+	 *        `RESULT_UNKNOWN` si terminó sin respuesta.
+	 */
+	int get_result() const
+	{
+		return result;
+	}
+
+	/**
+	 * @brief Cambia los límites de las siguientes llamadas a `solve` (ver `SolverOptions::time_limit`).
+	 */
+	void set_limits(double time_limit, uint64_t conflict_limit, uint64_t propagation_limit, uint64_t memory_limit)
+	{
+		options.time_limit = time_limit;
+		options.conflict_limit = conflict_limit;
+		options.propagation_limit = propagation_limit;
+		options.memory_limit = memory_limit;
+	}
+
+	/**
+	 * @brief Hace que `solve` llame a `monitor->poll` antes de cada decisión (ver `SolverMonitor::attach`).
+	 */
+	void set_monitor(SolverMonitor *monitor)
+	{
+		this->monitor = monitor;
+	}
+
+	/**
+	 * @brief Comparte las cláusulas aprendidas unitarias y binarias con otros solvers de la misma
+	 *        fórmula a través de `exchange`, donde este solver es el número `id`.
+	 *
+	 * Las cláusulas recibidas se agregan cada vez que la búsqueda vuelve al nivel 0.
+	 */
+	void set_clause_exchange(ClauseExchange *exchange, uint id)
+	{
+		clause_exchange = exchange;
+		exchange_id = id;
+		exchange_positions.assign(exchange->num_solvers(), 0);
+	}
+
+private:
+	SolverOptions options;
+
+	uint num_variables;
+
+	/**
+	 * Se agrego una clausula vacia, la formula no se puede satisfacer.
+	 */
+	bool empty_clause_added;
+
+	/**
+	 * El almacen donde se guardan, una detras de otra, todas las clausulas (originales y aprendidas).
+	 */
+	ClauseArena clause_arena;
+
+	/**
+	 * Las referencias a las clausulas originales del problema dentro de `clause_arena`.
+	 */
+	std::vector<ClauseRef> clauses;
+
+	/**
+	 * Una lista que contiene las clausulas donde un literal aparece de manera positiva.
+	 */
+	std::vector<std::vector<ClauseRef>> positive_clauses;
+
+	/**
+	 * Una lista que contiene las clausulas donde un literal aparece de manera negativa.
+	 */
+	std::vector<std::vector<ClauseRef>> negative_clauses;
+
+	/**
+	 * Una lista que contiene las clausulas que vigilan a un literal positivo.
+	 * Las clausulas siempre vigilan sus dos primeros literales.
+	 */
+	std::vector<std::vector<ClauseRef>> positive_watches;
+
+	/**
+	 * Una lista que contiene las clausulas que vigilan a un literal negativo.
+	 */
+	std::vector<std::vector<ClauseRef>> negative_watches;
+
+	/**
+	 * Cantidad de clausulas (originales y aprendidas) donde aparece cada literal positivo.
+	 * Es una cota del tamaño de su lista de vigilancia y se usa para reservar su capacidad.
+	 */
+	std::vector<uint> positive_occurrences;
+
+	/**
+	 * Cantidad de clausulas (originales y aprendidas) donde aparece cada literal negativo.
+	 */
+	std::vector<uint> negative_occurrences;
+
+	/**
+	 * Las referencias a las clausulas aprendidas en los conflictos (solo en modo `CDCL`). Cada una
+	 * guarda en el arena su LBD y su actividad, con las que `reduce_learned_clauses` decide cuales borrar.
+	 */
+	std::vector<ClauseRef> learned_clauses;
+
+	/**
+	 * Lo que se le suma a la actividad de una clausula aprendida que participa en un conflicto.
+	 */
+	double clause_activity_increment;
+
+	/**
+	 * Cantidad de conflictos en la que toca la siguiente reduccion y el intervalo que se uso para calcularla.
+	 */
+	uint64_t next_reduce;
+
+	uint64_t reduce_interval;
+
+	std::vector<int> model;
+
+	/**
+	 * una pila que contendra todas las decisiones que se han tomado.
+	 */
+	std::vector<int> model_stack;
+
+	/**
+	 * El nivel de decision en el que se asigno cada variable.
+	 */
+	std::vector<uint> variable_level;
+
+	/**
+	 * La clausula que obligo a asignar cada variable. Es `CLAUSE_REF_UNDEF` para las decisiones
+	 * y para los literales asignados sin una clausula que los implique.
+	 */
+	std::vector<ClauseRef> variable_reason;
+
+	/**
+	 * La clausula donde se encontro el ultimo conflicto.
+	 */
+	ClauseRef conflicting_clause;
+
+	/**
+	 * Marca las variables que ya se visitaron durante el analisis de un conflicto.
+	 */
+	std::vector<bool> seen;
+
+	/**
+	 * La clausula que se esta aprendiendo y los literales que se le quitaron al minimizarla.
+	 * Se guardan aqui para no pedir memoria en cada conflicto.
+	 */
+	std::vector<int> learned_clause;
+
+	std::vector<int> removed_literals;
+
+	/**
+	 * El indice de la siguiente literal que se va a propagar.
+	 */
+	uint index_of_next_literal_to_propagate;
+
+	/**
+	 * la profundidad del arbol de decision.
+	 */
+	uint decision_level;
+
+	/**
+	 * Cantidad de conflictos que se han encontrado donde un literal esta en forma positiva.
+	 */
+	std::vector<double> positive_literal_activity;
+
+	/**
+	 * Cantidad de conflictos que se han encontrado donde un literal esta en forma negativa.
+	 */
+	std::vector<double> negative_literal_activity;
+
+	/**
+	 * Lo que se le suma a la actividad de un literal en el proximo conflicto. Crece de forma exponencial.
+	 */
+	double activity_increment;
+
+	/**
+	 * Cola de prioridad con las variables ordenadas por actividad (la mayor de las actividades de sus
+	 * dos literales). Toda variable sin asignar esta en la cola, las asignadas se van sacando a medida
+	 * que se eligen como decision.
+	 */
+	VariableHeap decision_heap;
+
+	/**
+	 * El ultimo valor (`TRUE` o `FALSE`) que tuvo cada variable antes de desasignarse, o
+	 * `UNASSIGNED` si nunca tuvo valor. Se usa con `POLARITY_SAVED`.
+	 */
+	std::vector<int> saved_phase;
+
+	/**
+	 * Estado del generador de numeros al azar de `POLARITY_RANDOM`.
+	 */
+	uint64_t random_state;
+
+	/**
+	 * Conflictos desde el ultimo reinicio y conflictos que faltan para el siguiente (en las
+	 * politicas con intervalos fijos).
+	 */
+	uint64_t conflicts_since_restart;
+
+	uint64_t restart_limit;
+
+	/**
+	 * Reinicios hechos en la llamada a `solve` en curso. El calendario de reinicios empieza de
+	 * nuevo en cada llamada, como si fuera una búsqueda nueva.
+	 */
+	uint64_t solve_restarts;
+
+	/**
+	 * El LBD de las ultimas `GLUCOSE_LBD_WINDOW` clausulas aprendidas (una cola circular) y su suma,
+	 * y la suma de los LBD de todas las clausulas aprendidas. Solo se usan con `RESTART_GLUCOSE`.
+	 */
+	std::vector<uint> recent_lbds;
+
+	uint recent_lbds_next;
+
+	uint64_t recent_lbds_sum;
+
+	uint64_t total_lbds_sum;
+
+	/**
+	 * Marca de cada nivel de decision para contar los niveles distintos de una clausula.
+	 */
+	std::vector<uint64_t> level_stamp;
+
+	uint64_t current_level_stamp;
+
+	/**
+	 * Se preprocesó la fórmula: `clauses` tiene la fórmula simplificada, `original_formula` la que
+	 * se agregó y `preprocessor` lo necesario para completar el modelo.
+	 */
+	bool preprocessed;
+
+	CnfFormula original_formula;
+
+	Preprocessor preprocessor;
+
+	const std::atomic<bool> *stop_flag = nullptr;
+
+	bool stopped = false;
+
+	int result = RESULT_UNKNOWN;
+
+	/**
+	 * Cuándo empezó la llamada a `solve` en curso y los contadores en ese momento, para los límites
+	 * de `options`, y cuántas decisiones faltan para volver a mirar el reloj y la memoria.
+	 */
+	bool has_limits = false;
+
+	std::chrono::steady_clock::time_point solve_start_time;
+
+	uint64_t solve_start_conflicts = 0;
+
+	uint64_t solve_start_propagations = 0;
+
+	uint limit_check_countdown = 0;
+
+	SolverMonitor *monitor = nullptr;
+
+	ClauseExchange *clause_exchange = nullptr;
+
+	uint exchange_id = 0;
+
+	/**
+	 * Hasta dónde se leyó el buffer de cada solver en `clause_exchange`.
+	 */
+	std::vector<uint64_t> exchange_positions;
+
+	/**
+	 * Las suposiciones de la llamada a `solve` en curso: la i-esima se decide en el nivel i + 1.
+	 */
+	std::vector<int> assumptions;
+
+	std::vector<int> failed_assumptions;
+
+	SolverStatistics statistics;
+
+	void grow_variables(uint max_var);
+
+	uint &occurrences(int literal);
+
+	std::vector<ClauseRef> &watch_list(int literal);
+
+	void attach_clause(ClauseRef clause_ref);
+
+	void set_literal_to_true(int literal, ClauseRef reason = CLAUSE_REF_UNDEF);
+
+	void unassign(int literal);
+
+	void update_activity_literal(int literal);
+
+	void update_activity_conflicting_clause(ClauseRef clause);
+
+	bool propagate_occurrence_lists();
+
+	bool propagate_watched_literals();
+
+	bool propagate_conflicts();
+
+	void backtrack();
+
+	uint analyze_conflict();
+
+	void backjump(uint level);
+
+	ClauseRef add_learned_clause(uint lbd);
+
+	void update_activity_clause(ClauseRef clause_ref);
+
+	bool is_locked(ClauseRef clause_ref);
+
+	void reduce_learned_clauses();
+
+	void compact_clause_arena();
+
+	void rebuild_propagation_lists();
+
+	bool import_shared_clauses();
+
+	int probe_literal(int literal);
+
+	void learn_and_backjump();
+
+	void decide(int literal);
+
+	void analyze_failed_assumption(int assumption);
+
+	uint compute_lbd(const int *begin, const int *end);
+
+	void update_restart_limit();
+
+	bool should_restart();
+
+	void restart();
+
+	int get_next_decision_literal();
+
+	int choose_polarity(uint var);
+
+	bool preprocess();
+
+	void check_model();
+
+	bool exit_with_satisfiability(bool satisfiable);
+
+	const char *check_limits();
+
+	bool stop_search(const char *reason);
+
+	bool execute_DPLL();
+
+	bool check_unit_clauses();
+};
+
+/**
+ * @brief Lee una opción del solver de la línea de comandos, si `argv[i]` es una.
+ *
+ * Reconoce `--restart none|luby|geometric|glucose`, `--restart-interval <conflictos>`,
+ * `--polarity saved|false|true|random|activity`, `--seed <semilla>`, `--reduce-interval <conflictos>`,
+ * `--preprocess`/`--no-preprocess`, `--time-limit <segundos>`, `--conflict-limit <conflictos>`,
+ * `--propagation-limit <propagaciones>` y `--mem-limit <megabytes>`.
+ * Si la opción tiene un valor, deja `i` en la posición del valor.
+ *
+ * @return `true` si `argv[i]` era una opción del solver y su valor es válido.
+ */
+bool parse_solver_option(int argc, char *argv[], int &i, SolverOptions &options);
+
+/**
+ * @brief Imprime la ayuda de las opciones que reconoce `parse_solver_option`.
+ */
+void print_solver_options_usage(std::ostream &out);
+
+/**
+ * @brief Parsea un archivo en formato DIMACS y agrega sus cláusulas a un solver.
+ *
+ * @param file_path La ruta del archivo en formato DIMACS.
+ * @param solver El solver donde se agregan las variables y cláusulas.
+ *
+ * @return El tamaño del archivo y el tiempo que tomó leerlo.
+ *
+ * @throws std::runtime_error Si el archivo no se puede abrir o no cumple con el formato DIMACS.
+ */
+ParseStatistics parse_DIMACS_input(const std::string &file_path, Solver &solver);
+
 /**
  * @brief Resuelve un problema de satisfacibilidad booleana (SAT) dado en formato DIMACS.
  *
@@ -55,15 +808,20 @@ std::tuple<std::vector<std::vector<int>>, std::set<int>>  parse_DIMACS_to_clause
  *                         - Comentarios opcionales que comienzan con 'c'.
  *                         - Una línea de encabezado que comienza con 'p' y especifica el número de variables y cláusulas.
  *                         - Las cláusulas, donde cada línea contiene literales separados por espacios y termina con un '0'.
+ * @param statistics Si no es `nullptr`, se guardan aquí las estadísticas de la búsqueda (solo en la tercera versión).
+ * @param options Las opciones de la búsqueda (solo en la tercera versión).
+ * @param monitor Si no es `nullptr`, vigila la búsqueda (solo en la tercera versión, ver `SolverMonitor::attach`).
  *
- * @return std::pair<bool, std::map<int, bool>>
- *         - El primer elemento del `pair` es un booleano que indica si la fórmula es satisfacible (`true`) o insatisfacible (`false`).
+ * @return std::pair<int, std::map<int, bool>>
+ *         - El primer elemento del `pair` es `RESULT_SAT` si la fórmula es satisfacible, `RESULT_UNSAT` si es
+ *           insatisfacible y `RESULT_UNKNOWN` si la búsqueda alcanzó un límite de `options` o se interrumpió.
  *         - El segundo elemento es un mapa que representa el modelo (asignación de valores a las variables) si la fórmula es satisfacible.
  *           Si la fórmula es insatisfacible, este mapa estará vacío.
  *
  * @throws std::runtime_error Si:
  *         - El archivo no se puede abrir o leer.
  *         - El archivo no cumple con el formato DIMACS esperado.
+ *         - `VERSION` no es 1, 2 ni 3.
  *
  * @note Ejemplo de entrada en formato DIMACS:
  *       c Este es un comentario
@@ -73,11 +831,27 @@ std::tuple<std::vector<std::vector<int>>, std::set<int>>  parse_DIMACS_to_clause
  *
  * @note Ejemplo de salida:
  *       - Si la fórmula es satisfacible:
- *         {true, {{1, true}, {2, false}, {3, true}}}
+ *         {RESULT_SAT, {{1, true}, {2, false}, {3, true}}}
  *       - Si la fórmula es insatisfacible:
- *         {false, {}}
+ *         {RESULT_UNSAT, {}}
+ */
+std::pair<int, std::map<int, bool>> dpll_solver(std::string dimacs_file_path, SolverStatistics *statistics = nullptr,
+												const SolverOptions &options = SolverOptions(),
+												SolverMonitor *monitor = nullptr);
+
+/**
+ * @brief Imprime las estadísticas de una ejecución del solver (decisiones, propagaciones,
+ *        conflictos, cláusulas aprendidas, reinicios y reservas de memoria hechas durante la propagación).
+ *
+ * @param statistics Las estadísticas a imprimir.
+ * @param out El flujo donde se escriben las estadísticas.
+ */
+void print_solver_statistics(const SolverStatistics &statistics, std::ostream &out);
+
+/**
+ * @brief Devuelve el nombre de un resultado de `Solver::get_result`: `SAT`, `UNSAT` o `UNKNOWN`.
  */
-std::pair<bool, std::map<int, bool>> dpll_solver(std::string dimacs_file_path);
+const char *result_name(int result);
 
 bool main_test(const std::string &file_path);
 
@@ -0,0 +1,72 @@
+#ifndef PORTFOLIO_SOLVER_H
+#define PORTFOLIO_SOLVER_H
+#include <atomic>
+#include <map>
+#include <string>
+#include "dpllSolver.h"
+
+/**
+ * @brief Resultado de resolver una fórmula con `solve_portfolio`.
+ */
+struct PortfolioResult
+{
+	bool satisfiable = false;
+
+	/**
+	 * Todos los solvers alcanzaron un límite de `SolverOptions` o se interrumpieron sin respuesta;
+	 * entonces no hay ganador y las estadísticas son las del solver 0.
+	 */
+	bool stopped = false;
+
+	/**
+	 * El número del solver que terminó primero y las opciones con las que corrió.
+	 */
+	uint winner = 0;
+
+	SolverOptions winner_options;
+
+	/**
+	 * Las estadísticas y el modelo del solver ganador.
+	 */
+	SolverStatistics statistics;
+
+	std::map<int, bool> model;
+};
+
+/**
+ * @brief Devuelve las opciones del solver número `index` de un portafolio.
+ *
+ * El solver 0 usa `base` sin cambios. Los demás combinan otras políticas de reinicio, signos de
+ * decisión e intervalos de reinicio y de reducción, con una semilla distinta cada uno, para que
+ * cada solver explore una parte distinta del espacio de búsqueda.
+ */
+SolverOptions portfolio_options(const SolverOptions &base, uint index);
+
+/**
+ * @brief Describe en una línea las opciones de búsqueda de un solver (política de reinicios,
+ *        signo de las decisiones y semilla).
+ */
+std::string describe_solver_options(const SolverOptions &options);
+
+/**
+ * @brief Resuelve una fórmula con `num_solvers` solvers en paralelo, uno por hilo, cada uno con
+ *        las opciones de `portfolio_options`.
+ *
+ * El archivo se lee una sola vez; todos los hilos construyen su solver a partir de la misma
+ * `CnfFormula`, que solo leen. El primer solver que termina gana y los demás se detienen
+ * con `Solver::set_stop_flag`. Los límites de `options` valen para cada solver por separado.
+ *
+ * @param dimacs_file_path La fórmula, en el formato de `parse_DIMACS_file`.
+ * @param num_solvers La cantidad de solvers (al menos 1).
+ * @param options Las opciones del solver 0, de las que se derivan las de los demás.
+ * @param share_clauses Compartir las cláusulas aprendidas unitarias y binarias entre los solvers
+ *                      con un `ClauseExchange`.
+ * @param interrupt Si no es `nullptr`, el hilo que llama la revisa mientras espera y, cuando es
+ *                  verdadera, detiene a todos los solvers (el resultado queda con `stopped`).
+ *
+ * @throws std::runtime_error Si el archivo no se puede leer.
+ */
+PortfolioResult solve_portfolio(const std::string &dimacs_file_path, uint num_solvers, const SolverOptions &options,
+								bool share_clauses = true, const std::atomic<bool> *interrupt = nullptr);
+
+#endif // !PORTFOLIO_SOLVER_H
@@ -0,0 +1,217 @@
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "cnfFormula.h"
+
+/**
+ * Una variable solo se intenta eliminar si aparece en a lo sumo esta cantidad de cláusulas
+ * (sumando las dos polaridades). Eliminar variables con muchas apariciones rara vez reduce la fórmula.
+ */
+#define ELIMINATION_OCCURRENCE_LIMIT 16
+
+/**
+ * No se elimina una variable si algún resolvente tiene más literales que este límite.
+ */
+#define ELIMINATION_RESOLVENT_LIMIT 20
+
+/**
+ * No se buscan las cláusulas subsumidas por una cláusula si todos sus literales aparecen en más
+ * cláusulas que este límite (la búsqueda sería demasiado cara para lo que se suele ganar).
+ */
+#define SUBSUMPTION_OCCURRENCE_LIMIT 1000
+
+/**
+ * Cantidad máxima de rondas de eliminación de variables (cada una seguida de subsunción).
+ */
+#define PREPROCESS_ROUNDS 3
+
+/**
+ * @brief Lo que hizo el preprocesamiento de una fórmula.
+ */
+struct PreprocessStatistics
+{
+	uint64_t clauses_before = 0;
+
+	uint64_t clauses_after = 0;
+
+	/**
+	 * Variables con valor fijo por la propagación de cláusulas unitarias.
+	 */
+	uint64_t fixed_variables = 0;
+
+	/**
+	 * Cláusulas tautológicas (con un literal y su negación) o repetidas.
+	 */
+	uint64_t removed_clauses = 0;
+
+	uint64_t subsumed_clauses = 0;
+
+	/**
+	 * Cláusulas a las que se les quitó un literal por resolución con una cláusula que casi las subsume.
+	 */
+	uint64_t strengthened_clauses = 0;
+
+	uint64_t eliminated_variables = 0;
+
+	double seconds = 0.0;
+};
+
+/**
+ * @brief Simplifica una fórmula antes de buscarle un modelo.
+ *
+ * Aplica, en este orden:
+ * - Propagación de las cláusulas unitarias (en el nivel 0).
+ * - Eliminación de literales repetidos, de cláusulas tautológicas y de cláusulas repetidas.
+ * - Subsunción: si C está contenida en D, D sobra.
+ * - Resolución con autosubsunción: si C sin el literal l está contenida en D y D contiene -l,
+ *   se puede quitar -l de D.
+ * - Eliminación acotada de variables: una variable v se elimina reemplazando sus cláusulas por
+ *   todas las resolventes en v, si no son más que las cláusulas que reemplazan.
+ *
+ * Las cláusulas de las variables eliminadas se guardan para que `extend_model` pueda darles un
+ * valor a partir de un modelo de la fórmula simplificada.
+ *
+ * @note Ejemplo de uso:
+ *       Preprocessor preprocessor;
+ *       preprocessor.add_clause(literals, size); // por cada cláusula
+ *       CnfFormula simplified;
+ *       if (preprocessor.simplify(simplified))
+ *       {
+ *           // resolver simplified y luego completar el modelo con
+ *           preprocessor.extend_model(model);
+ *       }
+ */
+class Preprocessor
+{
+public:
+	/**
+	 * @brief Agrega una cláusula de la fórmula original. Se debe llamar antes de `simplify`.
+	 */
+	void add_clause(const int *literals, uint32_t size);
+
+	/**
+	 * @brief Simplifica las cláusulas agregadas y escribe el resultado en `formula`.
+	 *
+	 * Las variables con valor fijo se escriben como cláusulas unitarias. Después de llamarla se
+	 * libera la memoria de las cláusulas; solo se conserva lo necesario para `extend_model`.
+	 *
+	 * @return `false` si se demostró que la fórmula es insatisfacible, `true` en otro caso.
+	 */
+	bool simplify(CnfFormula &formula);
+
+	/**
+	 * @brief Impide que se elimine la variable `var`, por ejemplo porque se va a usar en suposiciones
+	 *        o en cláusulas que se agregan después de simplificar. Se debe llamar antes de `simplify`.
+	 */
+	void freeze(uint32_t var)
+	{
+		grow(var);
+		frozen[var] = true;
+	}
+
+	/**
+	 * @brief Indica si la variable fue eliminada (no aparece en la fórmula simplificada).
+	 */
+	bool is_eliminated(uint32_t var) const
+	{
+		return var < eliminated.size() and eliminated[var];
+	}
+
+	/**
+	 * @brief Completa un modelo de la fórmula simplificada con los valores de las variables eliminadas,
+	 *        de modo que satisfaga la fórmula original.
+	 *
+	 * @param model El valor de cada variable: 1 verdadero, 0 falso (como `Solver::get_literal_value`).
+	 */
+	void extend_model(std::vector<int> &model) const;
+
+	const PreprocessStatistics &get_statistics() const
+	{
+		return statistics;
+	}
+
+private:
+	/**
+	 * Las cláusulas, con sus literales ordenados por variable. Las borradas quedan vacías y
+	 * marcadas en `removed`.
+	 */
+	std::vector<std::vector<int>> clauses;
+
+	std::vector<bool> removed;
+
+	/**
+	 * Para cada cláusula, un bit por cada variable (módulo 64). Si C está contenida en D, todos los
+	 * bits de C están en D, lo que descarta rápido la mayoría de los pares.
+	 */
+	std::vector<uint64_t> signatures;
+
+	/**
+	 * Las cláusulas donde aparece cada literal, en la posición 2v para v y 2v + 1 para -v. Pueden tener cláusulas
+	 * borradas, que se quitan al recorrerlas con `clean_occurrences`.
+	 */
+	std::vector<std::vector<uint32_t>> occurrences;
+
+	/**
+	 * El valor fijo de cada variable: 1, 0 o -1 si no tiene.
+	 */
+	std::vector<int> values;
+
+	std::vector<bool> eliminated;
+
+	/**
+	 * Las variables que no se pueden eliminar (ver `freeze`).
+	 */
+	std::vector<bool> frozen;
+
+	/**
+	 * Los literales con valor fijo que falta propagar, desde `next_unit`.
+	 */
+	std::vector<int> units;
+
+	size_t next_unit = 0;
+
+	/**
+	 * Las cláusulas nuevas o reducidas, con las que falta buscar subsunciones.
+	 */
+	std::vector<uint32_t> subsumption_queue;
+
+	std::vector<bool> queued;
+
+	/**
+	 * Las cláusulas borradas al eliminar variables, para `extend_model`. Cada una se guarda como
+	 * sus literales (el primero es el de la variable eliminada) seguidos de su tamaño.
+	 */
+	std::vector<int> reconstruction_stack;
+
+	bool unsatisfiable = false;
+
+	PreprocessStatistics statistics;
+
+	void grow(uint32_t var);
+
+	std::vector<uint32_t> &clean_occurrences(int literal);
+
+	void assign(int literal);
+
+	void store_clause(std::vector<int> &clause);
+
+	void remove_clause(uint32_t index);
+
+	void remove_literal(uint32_t index, int literal);
+
+	bool propagate();
+
+	void remove_duplicates();
+
+	void subsume_with(uint32_t index);
+
+	bool subsume_queued();
+
+	bool eliminate_variable(uint32_t var);
+
+	bool eliminate_variables();
+};
+
+#endif // !PREPROCESSOR_H
@@ -0,0 +1,168 @@
+#ifndef SOLVER_MONITOR_H
+#define SOLVER_MONITOR_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "dpllSolver.h"
+
+/**
+ * Cada cuántas llamadas a `SolverMonitor::poll` (una por decisión) se mira el reloj para
+ * saber si toca imprimir una línea de progreso.
+ */
+#define MONITOR_POLL_PERIOD 1024
+
+/**
+ * @brief Muestra cómo avanza la búsqueda de un solver: líneas de progreso periódicas y un
+ *        volcado de todas las estadísticas cuando el proceso recibe una señal.
+ *
+ * - Cada `progress_interval` segundos escribe una línea con los conflictos y propagaciones por
+ *   segundo del último intervalo, la profundidad de la búsqueda, el tamaño de la pila de
+ *   asignaciones, las cláusulas aprendidas vivas y la memoria del proceso.
+ * - Con SIGUSR1 escribe todas las estadísticas y la búsqueda sigue.
+ * - Con SIGINT la búsqueda se detiene (el solver termina como con `Solver::set_stop_flag`) para
+ *   que el programa pueda mostrar lo que lleva; un segundo SIGINT termina el proceso.
+ *
+ * Las señales solo marcan banderas: todo lo demás lo hace el hilo del solver en `poll`.
+ *
+ * @note Ejemplo de uso:
+ *       SolverMonitor monitor(std::cerr, 10);
+ *       monitor.install_signal_handlers();
+ *       monitor.attach(solver);
+ *       solver.solve();
+ *       if (monitor.was_interrupted()) { ... }
+ */
+class SolverMonitor
+{
+public:
+	/**
+	 * @param out Donde se escriben las líneas de progreso y los volcados.
+	 * @param progress_interval Segundos entre líneas de progreso; con 0 no se escriben.
+	 */
+	SolverMonitor(std::ostream &out, double progress_interval = 0);
+
+	/**
+	 * @brief Instala los manejadores de SIGINT y SIGUSR1. Son del proceso, así que solo tiene
+	 *        sentido un monitor con señales a la vez.
+	 */
+	void install_signal_handlers();
+
+	/**
+	 * @brief Hace que el solver llame a `poll` antes de cada decisión y que se detenga con SIGINT.
+	 *
+	 * Un monitor vigila un solo solver, desde el hilo de ese solver.
+	 */
+	void attach(Solver &solver);
+
+	/**
+	 * @brief Guarda las estadísticas de la lectura de la fórmula, que el solver no conoce, para
+	 *        incluirlas en los volcados.
+	 */
+	void set_parse_statistics(const ParseStatistics &statistics)
+	{
+		parse_statistics = statistics;
+	}
+
+	/**
+	 * @brief La bandera que activa SIGINT, para los modos con varios hilos que no usan `attach`
+	 *        (ver `solve_portfolio` y `solve_cubes`).
+	 */
+	const std::atomic<bool> *interrupt_flag() const
+	{
+		return &interrupt_requested;
+	}
+
+	/**
+	 * @brief Indica si se recibió SIGINT.
+	 */
+	bool was_interrupted() const
+	{
+		return interrupt_requested.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Lo llama el solver antes de cada decisión. Casi siempre solo suma un contador.
+	 */
+	void poll(const Solver &solver)
+	{
+		if (dump_requested.load(std::memory_order_relaxed) or ++polls % MONITOR_POLL_PERIOD == 0)
+		{
+			check(solver);
+		}
+	}
+
+	/**
+	 * @brief Escribe una línea de progreso con el estado actual del solver.
+	 */
+	void print_progress(const Solver &solver);
+
+	/**
+	 * @brief Escribe todas las estadísticas del solver, con las tasas desde el principio y la memoria.
+	 */
+	void print_dump(const Solver &solver);
+
+	/**
+	 * @brief Segundos desde que se creó el monitor.
+	 */
+	double elapsed_seconds() const;
+
+private:
+	std::ostream &out;
+
+	double progress_interval;
+
+	std::chrono::steady_clock::time_point start_time;
+
+	/**
+	 * Cuándo se escribió la última línea de progreso y los contadores en ese momento, para
+	 * calcular las tasas del intervalo.
+	 */
+	double last_progress_seconds = 0;
+
+	uint64_t last_conflicts = 0;
+
+	uint64_t last_propagations = 0;
+
+	uint64_t polls = 0;
+
+	ParseStatistics parse_statistics;
+
+	/**
+	 * Las banderas que activan los manejadores de señales.
+	 */
+	static std::atomic<bool> interrupt_requested;
+
+	static std::atomic<bool> dump_requested;
+
+	static void handle_signal(int signal);
+
+	/**
+	 * @brief Escribe el volcado si se pidió con SIGUSR1 y la línea de progreso si ya pasó el intervalo.
+	 */
+	void check(const Solver &solver);
+};
+
+/**
+ * @brief Devuelve la memoria residente del proceso en bytes, o 0 si no se puede leer.
+ */
+uint64_t current_memory_bytes();
+
+/**
+ * @brief Devuelve la mayor memoria residente que ha usado el proceso, en bytes.
+ */
+uint64_t peak_memory_bytes();
+
+/**
+ * @brief Escribe las estadísticas de una ejecución como un objeto JSON en una sola línea.
+ *
+ * @param statistics Las estadísticas del solver.
+ * @param status `SAT`, `UNSAT`, `UNKNOWN` (se alcanzó un límite, ver `SolverStatistics::stop_reason`)
+ *               o `INTERRUPTED`.
+ * @param seconds El tiempo total de la ejecución, para las tasas por segundo.
+ * @param out El flujo donde se escribe el objeto.
+ */
+void write_solver_statistics_json(const SolverStatistics &statistics, const std::string &status, double seconds,
+								  std::ostream &out);
+
+#endif // !SOLVER_MONITOR_H
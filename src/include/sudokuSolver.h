@@ -1,21 +1,250 @@
 #ifndef SUDOKUSOLVER_H
 #define SUDOKUSOLVER_H
 
-#include <vector>
-#include <string>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <map>
 #include <iostream>
+#include "cnfFormula.h"
+#include "dpllSolver.h"
+
+/**
+ * Cantidad de sudokus que un hilo toma de la entrada cada vez en el modo por lotes.
+ */
+#define SUDOKU_BATCH_CHUNK 64
+
+/**
+ * Mayor tamaño de cuadrícula que se puede escribir con un caracter por celda (1-9 y A-Z).
+ */
+#define SUDOKU_MAX_SINGLE_CHAR_SIZE 35
+
+/**
+ * @brief Un sudoku de N x N celdas con subcuadrículas de D x D, donde N = D * D.
+ *
+ * La variable `var(r, c, v)` de la codificación completa es verdadera si la celda (r, c) tiene
+ * el valor v (con r, c y v entre 1 y N), así que la codificación completa tiene N^3 variables.
+ */
+struct Sudoku
+{
+	/**
+	 * D: el lado de cada subcuadrícula.
+	 */
+	int box_size;
+
+	/**
+	 * N: el lado de la cuadrícula y la cantidad de valores.
+	 */
+	int size;
+
+	/**
+	 * Las N*N celdas, fila por fila. 0 indica una celda vacía.
+	 */
+	std::vector<int> cells;
+
+	Sudoku(int box_size = 3) : box_size(box_size), size(box_size * box_size), cells(size * size, 0)
+	{
+	}
+
+	int var(int r, int c, int v) const
+	{
+		return (r - 1) * size * size + (c - 1) * size + v;
+	}
+};
+
+/**
+ * @brief Opciones de la codificación de un sudoku.
+ */
+struct SudokuOptions
+{
+	/**
+	 * Usar `encode_sudoku_compact` en lugar de la codificación completa de N*N*N variables.
+	 */
+	bool compact = false;
+
+	/**
+	 * Agregar las cláusulas redundantes "cada valor aparece a lo sumo una vez en cada fila,
+	 * columna y subcuadrícula", que ayudan a la propagación.
+	 */
+	bool redundant = false;
+
+	/**
+	 * Las opciones de búsqueda del solver.
+	 */
+	SolverOptions solver;
+};
+
+/**
+ * @brief Lee un sudoku de una línea con todas sus celdas.
+ *
+ * Se aceptan dos formatos, y el tamaño se deduce de la cantidad de celdas (que debe ser D^4):
+ * - Un caracter por celda: `1`-`9` y luego `A`-`Z` (10 a 35); `.`, `0` o cualquier otro caracter
+ *   es una celda vacía. Sirve hasta cuadrículas de 25 x 25.
+ * - Números separados por espacios, con `0` o `.` para las celdas vacías. Sirve para cualquier tamaño.
+ *
+ * @throws std::runtime_error Si la cantidad de celdas no es D^4 o algún valor es mayor que N.
+ */
+Sudoku parse_sudoku_line(const std::string &line);
+
+/**
+ * @brief Lee un sudoku de un archivo: una sola línea con todas las celdas (ver `parse_sudoku_line`),
+ *        o N filas de N celdas en cualquiera de los dos formatos.
+ *
+ * @throws std::runtime_error Si el archivo no se puede abrir o no tiene la forma de un sudoku.
+ */
+Sudoku read_sudoku(std::string sudoku_path);
+
+/**
+ * @brief Escribe las celdas de un sudoku en una línea, con el formato de un caracter por celda si
+ *        N <= `SUDOKU_MAX_SINGLE_CHAR_SIZE` o con números separados por espacios si es más grande.
+ */
+std::string format_sudoku(const Sudoku &sudoku);
+
+/**
+ * @brief Agrega a `formula` las reglas de un sudoku de subcuadrículas de `box_size` x `box_size`,
+ *        que son las mismas para todos los sudokus de ese tamaño: cada celda tiene exactamente un
+ *        valor y cada fila, columna y subcuadrícula tiene cada valor.
+ *
+ * Genera N^2 cláusulas de N literales por celda, N^2 * N(N-1)/2 binarias para que ninguna celda
+ * tenga dos valores y 3N^2 de N literales por unidad. Con `redundant` se agregan además
+ * 3N^2 * N(N-1)/2 binarias para que ningún valor se repita en una unidad.
+ *
+ * @param redundant Agregar también que cada valor aparece a lo sumo una vez en cada unidad.
+ */
+void encode_sudoku_rules(int box_size, CnfFormula &formula, bool redundant = false);
+
+/**
+ * @brief Agrega a `formula` una cláusula unitaria por cada pista del sudoku.
+ */
+void encode_sudoku_clues(const Sudoku &sudoku, CnfFormula &formula);
+
+/**
+ * @brief Agrega a `formula` las cláusulas que codifican el sudoku (reglas y pistas).
+ *
+ * @param sudoku El sudoku, como lo devuelve `read_sudoku`.
+ * @param formula La fórmula donde se agregan las cláusulas.
+ * @param redundant Agregar también que cada valor aparece a lo sumo una vez en cada unidad.
+ */
+void encode_sudoku(const Sudoku &sudoku, CnfFormula &formula, bool redundant = false);
+
+/**
+ * @brief Agrega a `formula` una codificación reducida del sudoku, que aprovecha las pistas.
+ *
+ * Las celdas con pista no tienen variables, y una celda vacía solo tiene variables para los
+ * valores que no aparecen como pista en su fila, columna o subcuadrícula. Tampoco se generan
+ * las cláusulas de las unidades donde una pista ya puso el valor. Las variables se numeran de
+ * forma consecutiva desde 1.
+ *
+ * @param sudoku El sudoku.
+ * @param redundant Agregar también que cada valor aparece a lo sumo una vez en cada unidad.
+ * @param formula La fórmula donde se agregan las cláusulas.
+ * @param variables Recibe, para cada `var(r, c, v)`, la variable de la fórmula que la representa
+ *                  o 0 si fue eliminada.
+ */
+void encode_sudoku_compact(const Sudoku &sudoku, bool redundant, CnfFormula &formula, std::vector<int> &variables);
+
+/**
+ * @brief Codifica un sudoku con la codificación completa o la compacta, según `options`.
+ *
+ * @param variables Recibe la numeración de `encode_sudoku_compact`, o queda vacío con la codificación completa.
+ */
+void encode_sudoku_with_options(const Sudoku &sudoku, const SudokuOptions &options, CnfFormula &formula,
+							   std::vector<int> &variables);
+
+/**
+ * @brief Codifica el sudoku de un archivo y lo devuelve como texto en formato DIMACS.
+ */
+std::string parse_sudoku_to_DIMACS(std::string sudoku_path, const SudokuOptions &options = SudokuOptions());
+
+std::string parse_model_to_solution(const Sudoku &sudoku, std::map<int, bool> model);
+
+/**
+ * @brief Lee la solución del sudoku directamente del modelo de un solver, sin construir un mapa.
+ *
+ * @param solver El solver, después de encontrar un modelo.
+ * @param sudoku El sudoku; las celdas con pista se copian tal cual.
+ * @param variables La numeración de `encode_sudoku_compact`, o vacío si se usó la codificación completa.
+ *
+ * @return La solución con el formato de `format_sudoku`, o una cadena vacía si el modelo no es
+ *         una solución válida.
+ */
+std::string parse_solver_to_solution(const Solver &solver, const Sudoku &sudoku, const std::vector<int> &variables = {});
+
+/**
+ * @brief Resuelve un sudoku en memoria: codifica las cláusulas, se las pasa al solver y lee la solución.
+ *
+ * @param sudoku El sudoku, como lo devuelve `read_sudoku`.
+ * @param solution Recibe la solución (con el formato de `format_sudoku`) si el sudoku tiene solución.
+ * @param statistics Si no es `nullptr`, recibe las estadísticas de la búsqueda.
+ * @param options La codificación a usar.
+ *
+ * @return `RESULT_SAT` si el sudoku tiene solución, `RESULT_UNSAT` si no tiene y `RESULT_UNKNOWN`
+ *         si la búsqueda alcanzó un límite de `options.solver`.
+ */
+int solve_sudoku(const Sudoku &sudoku, std::string &solution, SolverStatistics *statistics = nullptr,
+				 const SudokuOptions &options = SudokuOptions());
+
+/**
+ * @brief Crea un solver que ya tiene las reglas de los sudokus de un tamaño, para copiarlo en cada
+ *        sudoku de un lote.
+ */
+Solver build_sudoku_base_solver(int box_size, bool redundant = false, const SolverOptions &solver_options = SolverOptions());
+
+/**
+ * @brief Resuelve un sudoku a partir de una copia del solver base, agregando solo sus pistas.
+ *
+ * @param base_solver El solver devuelto por `build_sudoku_base_solver` para el tamaño del sudoku.
+ *                    No se modifica.
+ * @param sudoku El sudoku.
+ * @param solution Recibe la solución si el sudoku tiene solución.
+ *
+ * @return `RESULT_SAT`, `RESULT_UNSAT` o `RESULT_UNKNOWN`, como `solve_sudoku`.
+ */
+int solve_sudoku_with_base(const Solver &base_solver, const Sudoku &sudoku, std::string &solution);
+
+/**
+ * @brief Resumen de un lote de sudokus resueltos con `solve_sudoku_batch`.
+ */
+struct SudokuBatchSummary
+{
+	uint64_t puzzles = 0;
 
+	uint64_t solved = 0;
 
+	/**
+	 * Tiempo total del lote, en segundos.
+	 */
+	double seconds = 0.0;
 
-int const D = 3;
-int const N = D * D;
+	/**
+	 * Tiempo de cada sudoku en segundos, ordenado de menor a mayor.
+	 */
+	std::vector<double> latencies;
 
-std::string parse_sudoku_to_DIMACS(std::string sudoku_path);
+	/**
+	 * @brief Devuelve la latencia que deja por debajo al `percentile` por ciento de los sudokus.
+	 */
+	double latency_percentile(double percentile) const;
+};
 
-std::string parse_model_to_solution(std::map<int, bool> model);
+/**
+ * @brief Resuelve un sudoku por línea de `in` con un grupo de hilos.
+ *
+ * Con la codificación completa, las reglas de cada tamaño se codifican una sola vez en un solver
+ * base; cada sudoku se resuelve con una copia de ese solver a la que solo se le agregan las pistas.
+ * Los hilos van leyendo la entrada de a `SUDOKU_BATCH_CHUNK` líneas, así que no hace falta tenerla
+ * completa en memoria.
+ *
+ * @param in La entrada, con un sudoku por línea en el formato de `parse_sudoku_line` (las líneas
+ *           vacías se ignoran). Puede mezclar sudokus de distintos tamaños.
+ * @param num_threads La cantidad de hilos (al menos 1).
+ * @param options La codificación a usar. Con la codificación compacta cada sudoku se codifica por separado.
+ * @param out Recibe una línea `<número de línea>,<SAT|UNSAT|UNKNOWN|ERROR>,<solución>` por sudoku; con
+ *            `ERROR`, en lugar de la solución va el mensaje que dice por qué la línea no es válida. Las
+ *            líneas se escriben a medida que se resuelven, no necesariamente en orden.
+ *
+ * @return La cantidad de sudokus, el tiempo total y la latencia de cada sudoku.
+ */
+SudokuBatchSummary solve_sudoku_batch(std::istream &in, uint num_threads, const SudokuOptions &options, std::ostream &out);
 
-#endif // !SUDOKUSOLVER_H
\ No newline at end of file
+#endif // !SUDOKUSOLVER_H
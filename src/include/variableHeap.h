@@ -0,0 +1,106 @@
+#ifndef VARIABLE_HEAP_H
+#define VARIABLE_HEAP_H
+#include <vector>
+
+/**
+ * @brief Cola de prioridad (heap binario indexado) de variables ordenadas por actividad.
+ *
+ * Guarda las variables en un heap binario de máximos cuya clave es la actividad de cada
+ * variable. Además mantiene la posición de cada variable dentro del heap, lo que permite
+ * saber en O(1) si una variable está en la cola y actualizar su clave en O(log n).
+ *
+ * @note El heap es dueño de las actividades de las variables, de modo que se puede copiar
+ *       junto con el solver que lo contiene. Las actividades se conservan aunque la variable
+ *       salga del heap.
+ *
+ * @note Ejemplo de uso:
+ *       VariableHeap heap;
+ *       heap.grow(3);
+ *       heap.set_activity(1, 3.0); heap.set_activity(2, 1.0); heap.set_activity(3, 2.0);
+ *       heap.insert(1); heap.insert(2); heap.insert(3);
+ *       heap.pop_max(); // devuelve 1
+ */
+class VariableHeap
+{
+public:
+	/**
+	 * @brief Indica si la variable está actualmente en el heap.
+	 */
+	bool contains(unsigned int var) const
+	{
+		return var < positions.size() && positions[var] >= 0;
+	}
+
+	bool empty() const
+	{
+		return heap.empty();
+	}
+
+	unsigned int size() const
+	{
+		return heap.size();
+	}
+
+	/**
+	 * @brief Permite usar las variables hasta `max_var` (con actividad 0). No las agrega al heap.
+	 */
+	void grow(unsigned int max_var);
+
+	/**
+	 * @brief Devuelve la actividad de una variable.
+	 */
+	double activity(unsigned int var) const
+	{
+		return activities[var];
+	}
+
+	/**
+	 * @brief Cambia la actividad de una variable y, si está en el heap, la reacomoda
+	 *        (sube si la actividad aumentó y baja si disminuyó) en O(log n).
+	 */
+	void set_activity(unsigned int var, double activity);
+
+	/**
+	 * @brief Multiplica todas las actividades por un factor positivo. El orden no cambia.
+	 */
+	void scale_activities(double factor);
+
+	/**
+	 * @brief Agrega una variable al heap. Si ya está no hace nada.
+	 */
+	void insert(unsigned int var);
+
+	/**
+	 * @brief Saca y devuelve la variable con mayor actividad.
+	 *
+	 * @note El heap no puede estar vacío.
+	 */
+	unsigned int pop_max();
+
+	/**
+	 * @brief Vacía el heap. Las actividades no cambian.
+	 */
+	void clear();
+
+private:
+	/**
+	 * La actividad de cada variable, indexada por variable.
+	 */
+	std::vector<double> activities;
+
+	/**
+	 * Las variables ordenadas como un heap binario de máximos.
+	 */
+	std::vector<unsigned int> heap;
+
+	/**
+	 * La posición de cada variable dentro de `heap`, o -1 si la variable no está.
+	 */
+	std::vector<int> positions;
+
+	void sift_up(unsigned int position);
+
+	void sift_down(unsigned int position);
+};
+
+#endif // !VARIABLE_HEAP_H
@@ -0,0 +1,150 @@
+#include "portfolioSolver.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief Una configuración del portafolio: lo que cambia respecto de las opciones base.
+ */
+struct PortfolioConfiguration
+{
+	int restart_policy;
+
+	int polarity;
+
+	/**
+	 * Factores para `restart_interval` y `reduce_interval` de las opciones base.
+	 */
+	double restart_interval_factor;
+
+	double reduce_interval_factor;
+};
+
+/**
+ * Las configuraciones de los solvers 1 a 7; a partir del 8 se repiten con otra semilla.
+ */
+static const PortfolioConfiguration PORTFOLIO_CONFIGURATIONS[] = {
+	{RESTART_LUBY, POLARITY_SAVED, 1.0, 1.0},
+	{RESTART_GLUCOSE, POLARITY_ACTIVITY, 1.0, 1.0},
+	{RESTART_GEOMETRIC, POLARITY_RANDOM, 1.0, 1.0},
+	{RESTART_LUBY, POLARITY_ACTIVITY, 0.5, 1.0},
+	{RESTART_GLUCOSE, POLARITY_SAVED, 1.0, 2.0},
+	{RESTART_GEOMETRIC, POLARITY_FALSE, 2.0, 0.5},
+	{RESTART_LUBY, POLARITY_RANDOM, 1.0, 1.0},
+};
+
+#define NUM_PORTFOLIO_CONFIGURATIONS (sizeof(PORTFOLIO_CONFIGURATIONS) / sizeof(PORTFOLIO_CONFIGURATIONS[0]))
+
+SolverOptions portfolio_options(const SolverOptions &base, uint index)
+{
+	SolverOptions options = base;
+	if (index == 0)
+	{
+		return options;
+	}
+
+	const PortfolioConfiguration &configuration = PORTFOLIO_CONFIGURATIONS[(index - 1) % NUM_PORTFOLIO_CONFIGURATIONS];
+	options.restart_policy = configuration.restart_policy;
+	options.polarity = configuration.polarity;
+	options.restart_interval = std::max(1.0, base.restart_interval * configuration.restart_interval_factor);
+	options.reduce_interval = base.reduce_interval * configuration.reduce_interval_factor;
+	options.random_seed = base.random_seed + index;
+	return options;
+}
+
+std::string describe_solver_options(const SolverOptions &options)
+{
+	static const char *restart_names[] = {"none", "luby", "geometric", "glucose"};
+	static const char *polarity_names[] = {"saved", "false", "true", "random", "activity"};
+
+	return std::string("restart ") + restart_names[options.restart_policy] + " " +
+		   std::to_string(options.restart_interval) + ", polarity " + polarity_names[options.polarity] +
+		   ", reduce " + std::to_string(options.reduce_interval) + ", seed " + std::to_string(options.random_seed);
+}
+
+PortfolioResult solve_portfolio(const std::string &dimacs_file_path, uint num_solvers, const SolverOptions &options,
+								bool share_clauses, const std::atomic<bool> *interrupt)
+{
+	num_solvers = std::max(1u, num_solvers);
+
+	CnfFormula formula;
+	ParseStatistics parse_statistics = parse_DIMACS_file(dimacs_file_path, formula);
+
+	std::unique_ptr<ClauseExchange> exchange;
+	if (share_clauses and num_solvers > 1)
+	{
+		exchange.reset(new ClauseExchange(num_solvers));
+	}
+
+	std::vector<std::unique_ptr<Solver>> solvers(num_solvers);
+	std::vector<bool> results(num_solvers, false);
+	std::atomic<bool> stop(false);
+	std::atomic<int> winner(-1);
+	std::atomic<uint> finished_solvers(0);
+
+	auto worker = [&](uint index)
+	{
+		// Cada hilo construye su solver: la formula solo se lee
+		solvers[index].reset(new Solver(portfolio_options(options, index)));
+		Solver &solver = *solvers[index];
+		solver.set_stop_flag(&stop);
+		if (exchange)
+		{
+			solver.set_clause_exchange(exchange.get(), index);
+		}
+		solver.add_formula(formula);
+
+		bool result = solver.solve();
+		++finished_solvers;
+		if (solver.was_stopped())
+		{
+			return;
+		}
+
+		int expected = -1;
+		if (winner.compare_exchange_strong(expected, index))
+		{
+			results[index] = result;
+			stop.store(true, std::memory_order_relaxed);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (uint index = 0; index < num_solvers; ++index)
+	{
+		threads.emplace_back(worker, index);
+	}
+	while (interrupt != nullptr and finished_solvers.load() < num_solvers)
+	{
+		if (interrupt->load(std::memory_order_relaxed))
+		{
+			stop.store(true, std::memory_order_relaxed);
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(INTERRUPT_POLL_MS));
+	}
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	PortfolioResult result;
+	if (winner.load() < 0)
+	{
+		// Todos los solvers se detuvieron por sus limites o por `interrupt`
+		result.stopped = true;
+		result.statistics = solvers[0]->get_statistics();
+		result.statistics.parse = parse_statistics;
+		return result;
+	}
+	result.winner = winner.load();
+	result.winner_options = portfolio_options(options, result.winner);
+	result.satisfiable = results[result.winner];
+	result.statistics = solvers[result.winner]->get_statistics();
+	result.statistics.parse = parse_statistics;
+	if (result.satisfiable)
+	{
+		result.model = solvers[result.winner]->get_model();
+	}
+	return result;
+}
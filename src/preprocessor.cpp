@@ -0,0 +1,607 @@
+#include "preprocessor.h"
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Posición de un literal en `occurrences`: 2v para v y 2v + 1 para -v.
+ */
+static inline uint32_t literal_index(int literal)
+{
+	return literal > 0 ? 2 * literal : 2 * -literal + 1;
+}
+
+static inline uint32_t variable(int literal)
+{
+	return literal > 0 ? literal : -literal;
+}
+
+/**
+ * @brief Orden de los literales dentro de una cláusula: por variable y, con la misma variable,
+ *        primero el negativo. Así un literal y su negación quedan juntos.
+ */
+static inline bool literal_less(int a, int b)
+{
+	return variable(a) < variable(b) or (variable(a) == variable(b) and a < b);
+}
+
+static uint64_t compute_signature(const std::vector<int> &clause)
+{
+	uint64_t signature = 0;
+	for (int literal : clause)
+	{
+		signature |= uint64_t(1) << (variable(literal) % 64);
+	}
+	return signature;
+}
+
+/**
+ * @brief Ordena los literales de una cláusula y quita los repetidos.
+ *
+ * @return `false` si la cláusula es una tautología (tiene un literal y su negación).
+ */
+static bool normalize(std::vector<int> &clause)
+{
+	std::sort(clause.begin(), clause.end(), literal_less);
+	clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+	for (size_t i = 1; i < clause.size(); i++)
+	{
+		if (clause[i] == -clause[i - 1])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Revisa si la cláusula `c` subsume a `d`, o si la fortalece por autosubsunción.
+ *
+ * Ambas cláusulas deben estar ordenadas con `literal_less`.
+ *
+ * @param removable Recibe 0 si `c` está contenida en `d`, o el literal de `d` que se puede quitar
+ *                  si `c` está contenida en `d` salvo por un literal negado.
+ *
+ * @return `true` si `c` subsume a `d` o permite quitarle un literal.
+ */
+static bool subsumes(const std::vector<int> &c, const std::vector<int> &d, int &removable)
+{
+	removable = 0;
+	size_t j = 0;
+	for (int literal : c)
+	{
+		while (j < d.size() and variable(d[j]) < variable(literal))
+		{
+			++j;
+		}
+		if (j == d.size() or variable(d[j]) != variable(literal))
+		{
+			return false;
+		}
+		if (d[j] != literal)
+		{
+			// Solo se permite un literal negado
+			if (removable != 0)
+			{
+				return false;
+			}
+			removable = d[j];
+		}
+		++j;
+	}
+	return true;
+}
+
+/**
+ * @brief Calcula la resolvente de `c` y `d` en la variable `var`.
+ *
+ * @return `false` si la resolvente es una tautología.
+ */
+static bool resolve(const std::vector<int> &c, const std::vector<int> &d, uint32_t var, std::vector<int> &resolvent)
+{
+	resolvent.clear();
+	size_t i = 0, j = 0;
+	while (i < c.size() or j < d.size())
+	{
+		int literal;
+		if (j == d.size() or (i < c.size() and variable(c[i]) < variable(d[j])))
+		{
+			literal = c[i++];
+		}
+		else if (i == c.size() or variable(d[j]) < variable(c[i]))
+		{
+			literal = d[j++];
+		}
+		else
+		{
+			// La misma variable en las dos cláusulas
+			if (c[i] != d[j] and variable(c[i]) != var)
+			{
+				return false;
+			}
+			literal = c[i];
+			++i;
+			++j;
+		}
+
+		if (variable(literal) != var)
+		{
+			resolvent.push_back(literal);
+		}
+	}
+	return true;
+}
+
+void Preprocessor::grow(uint32_t var)
+{
+	if (var >= values.size())
+	{
+		values.resize(var + 1, -1);
+		eliminated.resize(var + 1, false);
+		frozen.resize(var + 1, false);
+		occurrences.resize(2 * var + 2);
+	}
+}
+
+/**
+ * @brief Quita de la lista de apariciones de `literal` las cláusulas borradas y la devuelve.
+ */
+std::vector<uint32_t> &Preprocessor::clean_occurrences(int literal)
+{
+	std::vector<uint32_t> &list = occurrences[literal_index(literal)];
+	list.erase(std::remove_if(list.begin(), list.end(), [this](uint32_t index) { return removed[index]; }),
+			   list.end());
+	return list;
+}
+
+/**
+ * @brief Le da valor verdadero a `literal` y lo encola para propagarlo. Si ya era falso, la
+ *        fórmula es insatisfacible.
+ */
+void Preprocessor::assign(int literal)
+{
+	uint32_t var = variable(literal);
+	int value = literal > 0 ? 1 : 0;
+	if (values[var] == value)
+	{
+		return;
+	}
+	if (values[var] != -1)
+	{
+		unsatisfiable = true;
+		return;
+	}
+	values[var] = value;
+	units.push_back(literal);
+	++statistics.fixed_variables;
+}
+
+/**
+ * @brief Guarda una cláusula ya normalizada, quitando los literales con valor fijo. Las cláusulas
+ *        unitarias no se guardan: se asigna su literal.
+ */
+void Preprocessor::store_clause(std::vector<int> &clause)
+{
+	size_t size = 0;
+	for (int literal : clause)
+	{
+		int value = values[variable(literal)];
+		if (value == -1)
+		{
+			clause[size++] = literal;
+		}
+		else if (value == (literal > 0 ? 1 : 0))
+		{
+			return;
+		}
+	}
+	clause.resize(size);
+
+	if (clause.empty())
+	{
+		unsatisfiable = true;
+		return;
+	}
+	if (clause.size() == 1)
+	{
+		assign(clause[0]);
+		return;
+	}
+
+	uint32_t index = clauses.size();
+	for (int literal : clause)
+	{
+		occurrences[literal_index(literal)].push_back(index);
+	}
+	signatures.push_back(compute_signature(clause));
+	clauses.push_back(std::move(clause));
+	removed.push_back(false);
+	queued.push_back(true);
+	subsumption_queue.push_back(index);
+}
+
+void Preprocessor::remove_clause(uint32_t index)
+{
+	removed[index] = true;
+	std::vector<int>().swap(clauses[index]);
+}
+
+/**
+ * @brief Quita `literal` de una cláusula. Si queda unitaria, se asigna su literal y se borra.
+ */
+void Preprocessor::remove_literal(uint32_t index, int literal)
+{
+	std::vector<int> &clause = clauses[index];
+	clause.erase(std::find(clause.begin(), clause.end(), literal));
+	std::vector<uint32_t> &list = occurrences[literal_index(literal)];
+	list.erase(std::find(list.begin(), list.end(), index));
+
+	if (clause.size() == 1)
+	{
+		assign(clause[0]);
+		remove_clause(index);
+		return;
+	}
+
+	signatures[index] = compute_signature(clause);
+	if (not queued[index])
+	{
+		queued[index] = true;
+		subsumption_queue.push_back(index);
+	}
+}
+
+/**
+ * @brief Propaga los literales con valor fijo: borra las cláusulas que satisfacen y se quitan
+ *        de las demás.
+ *
+ * @return `false` si se encontró una contradicción.
+ */
+bool Preprocessor::propagate()
+{
+	while (not unsatisfiable and next_unit < units.size())
+	{
+		int literal = units[next_unit++];
+		for (uint32_t index : occurrences[literal_index(literal)])
+		{
+			if (not removed[index])
+			{
+				remove_clause(index);
+			}
+		}
+		std::vector<uint32_t>().swap(occurrences[literal_index(literal)]);
+
+		// remove_literal modifica la lista, así que se recorre una copia
+		std::vector<uint32_t> falsified = clean_occurrences(-literal);
+		for (uint32_t index : falsified)
+		{
+			if (not removed[index])
+			{
+				remove_literal(index, -literal);
+			}
+		}
+	}
+	return not unsatisfiable;
+}
+
+/**
+ * @brief Borra las cláusulas repetidas, ordenando las cláusulas por su contenido.
+ */
+void Preprocessor::remove_duplicates()
+{
+	std::vector<uint32_t> order;
+	order.reserve(clauses.size());
+	for (uint32_t index = 0; index < clauses.size(); index++)
+	{
+		if (not removed[index])
+		{
+			order.push_back(index);
+		}
+	}
+
+	std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+		return clauses[a] < clauses[b];
+	});
+
+	for (size_t i = 1; i < order.size(); i++)
+	{
+		if (clauses[order[i]] == clauses[order[i - 1]])
+		{
+			remove_clause(order[i - 1]);
+			++statistics.removed_clauses;
+		}
+	}
+}
+
+/**
+ * @brief Borra las cláusulas subsumidas por la cláusula `index` y fortalece las que se pueden
+ *        fortalecer con ella.
+ *
+ * Toda cláusula subsumida o fortalecida contiene la variable de `index` con menos apariciones,
+ * así que solo se revisan las cláusulas de esa variable.
+ */
+void Preprocessor::subsume_with(uint32_t index)
+{
+	const std::vector<int> &clause = clauses[index];
+	int best = clause[0];
+	size_t best_occurrences = SIZE_MAX;
+	for (int literal : clause)
+	{
+		size_t count = occurrences[literal_index(literal)].size() + occurrences[literal_index(-literal)].size();
+		if (count < best_occurrences)
+		{
+			best = literal;
+			best_occurrences = count;
+		}
+	}
+	if (best_occurrences > SUBSUMPTION_OCCURRENCE_LIMIT)
+	{
+		return;
+	}
+
+	for (int literal : {best, -best})
+	{
+		std::vector<uint32_t> candidates = clean_occurrences(literal);
+		for (uint32_t other : candidates)
+		{
+			// La cláusula puede haberse borrado al fortalecer otra (si quedó unitaria)
+			if (removed[index])
+			{
+				return;
+			}
+			if (other == index or removed[other] or clauses[other].size() < clause.size() or
+				(signatures[index] & ~signatures[other]) != 0)
+			{
+				continue;
+			}
+
+			int removable;
+			if (not subsumes(clause, clauses[other], removable))
+			{
+				continue;
+			}
+			if (removable == 0)
+			{
+				remove_clause(other);
+				++statistics.subsumed_clauses;
+			}
+			else
+			{
+				remove_literal(other, removable);
+				++statistics.strengthened_clauses;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Busca subsunciones con las cláusulas encoladas hasta que la cola queda vacía,
+ *        propagando los literales que se van fijando.
+ *
+ * @return `false` si se encontró una contradicción.
+ */
+bool Preprocessor::subsume_queued()
+{
+	while (not subsumption_queue.empty())
+	{
+		if (not propagate())
+		{
+			return false;
+		}
+		uint32_t index = subsumption_queue.back();
+		subsumption_queue.pop_back();
+		queued[index] = false;
+		if (not removed[index])
+		{
+			subsume_with(index);
+		}
+	}
+	return propagate();
+}
+
+/**
+ * @brief Intenta eliminar la variable `var` por resolución.
+ *
+ * Se elimina solo si tiene pocas apariciones y sus resolventes no tautológicas no son más que
+ * las cláusulas donde aparece. Esas cláusulas se guardan en `reconstruction_stack` y se
+ * reemplazan por las resolventes.
+ *
+ * @return `true` si se eliminó la variable.
+ */
+bool Preprocessor::eliminate_variable(uint32_t var)
+{
+	if (values[var] != -1 or eliminated[var] or frozen[var])
+	{
+		return false;
+	}
+	std::vector<uint32_t> positive = clean_occurrences(var);
+	std::vector<uint32_t> negative = clean_occurrences(-int(var));
+	size_t limit = positive.size() + negative.size();
+	if (limit == 0 or limit > ELIMINATION_OCCURRENCE_LIMIT)
+	{
+		return false;
+	}
+
+	std::vector<std::vector<int>> resolvents;
+	std::vector<int> resolvent;
+	for (uint32_t p : positive)
+	{
+		for (uint32_t n : negative)
+		{
+			if (not resolve(clauses[p], clauses[n], var, resolvent))
+			{
+				continue;
+			}
+			if (resolvents.size() == limit or resolvent.size() > ELIMINATION_RESOLVENT_LIMIT)
+			{
+				return false;
+			}
+			resolvents.push_back(resolvent);
+		}
+	}
+
+	eliminated[var] = true;
+	++statistics.eliminated_variables;
+	for (int literal : {int(var), -int(var)})
+	{
+		for (uint32_t index : literal == int(var) ? positive : negative)
+		{
+			// El literal de la variable eliminada va primero: es el que se hace verdadero si hace falta
+			const std::vector<int> &clause = clauses[index];
+			reconstruction_stack.push_back(literal);
+			for (int other : clause)
+			{
+				if (other != literal)
+				{
+					reconstruction_stack.push_back(other);
+				}
+			}
+			reconstruction_stack.push_back(clause.size());
+			remove_clause(index);
+		}
+		std::vector<uint32_t>().swap(occurrences[literal_index(literal)]);
+	}
+
+	for (std::vector<int> &clause : resolvents)
+	{
+		store_clause(clause);
+	}
+	return true;
+}
+
+/**
+ * @brief Una ronda de eliminación de variables, empezando por las que tienen menos resolventes
+ *        posibles.
+ *
+ * @return `false` si se encontró una contradicción.
+ */
+bool Preprocessor::eliminate_variables()
+{
+	std::vector<std::pair<uint64_t, uint32_t>> candidates;
+	for (uint32_t var = 1; var < values.size(); var++)
+	{
+		if (values[var] != -1 or eliminated[var] or frozen[var])
+		{
+			continue;
+		}
+		uint64_t positive = clean_occurrences(var).size();
+		uint64_t negative = clean_occurrences(-int(var)).size();
+		if (positive + negative <= ELIMINATION_OCCURRENCE_LIMIT)
+		{
+			candidates.push_back({positive * negative, var});
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	for (auto &candidate : candidates)
+	{
+		if (eliminate_variable(candidate.second) and not propagate())
+		{
+			return false;
+		}
+	}
+	return not unsatisfiable;
+}
+
+void Preprocessor::add_clause(const int *literals, uint32_t size)
+{
+	++statistics.clauses_before;
+	std::vector<int> clause(literals, literals + size);
+	for (int literal : clause)
+	{
+		grow(variable(literal));
+	}
+
+	if (not normalize(clause))
+	{
+		++statistics.removed_clauses;
+		return;
+	}
+	store_clause(clause);
+}
+
+bool Preprocessor::simplify(CnfFormula &formula)
+{
+	auto start_time = std::chrono::steady_clock::now();
+
+	if (propagate())
+	{
+		remove_duplicates();
+		for (int round = 0; round < PREPROCESS_ROUNDS and subsume_queued(); round++)
+		{
+			uint64_t eliminated_before = statistics.eliminated_variables;
+			if (not eliminate_variables() or statistics.eliminated_variables == eliminated_before)
+			{
+				break;
+			}
+		}
+		subsume_queued();
+	}
+
+	formula.clear();
+	if (not unsatisfiable)
+	{
+		formula.num_variables = values.empty() ? 0 : values.size() - 1;
+		for (uint32_t var = 1; var < values.size(); var++)
+		{
+			if (values[var] != -1)
+			{
+				formula.add_clause({values[var] == 1 ? int(var) : -int(var)});
+			}
+		}
+		for (uint32_t index = 0; index < clauses.size(); index++)
+		{
+			if (not removed[index])
+			{
+				formula.add_clause(clauses[index]);
+			}
+		}
+		statistics.clauses_after = formula.num_clauses;
+	}
+
+	// Solo hace falta conservar lo que usa extend_model
+	std::vector<std::vector<int>>().swap(clauses);
+	std::vector<std::vector<uint32_t>>().swap(occurrences);
+	std::vector<bool>().swap(removed);
+	std::vector<bool>().swap(queued);
+	std::vector<uint64_t>().swap(signatures);
+	std::vector<uint32_t>().swap(subsumption_queue);
+	std::vector<int>().swap(units);
+	next_unit = 0;
+
+	std::chrono::duration<double> elapsed_time = std::chrono::steady_clock::now() - start_time;
+	statistics.seconds = elapsed_time.count();
+	return not unsatisfiable;
+}
+
+void Preprocessor::extend_model(std::vector<int> &model) const
+{
+	for (uint32_t var = 1; var < eliminated.size() and var < model.size(); var++)
+	{
+		if (eliminated[var])
+		{
+			model[var] = 0;
+		}
+	}
+
+	// Se recorren las cláusulas en el orden inverso al de eliminación: cuando se revisa una,
+	// las variables eliminadas después ya tienen su valor definitivo
+	size_t end = reconstruction_stack.size();
+	while (end > 0)
+	{
+		size_t size = reconstruction_stack[end - 1];
+		size_t begin = end - 1 - size;
+
+		bool satisfied = false;
+		for (size_t i = begin; i < end - 1 and not satisfied; i++)
+		{
+			int literal = reconstruction_stack[i];
+			satisfied = model[variable(literal)] == (literal > 0 ? 1 : 0);
+		}
+		if (not satisfied)
+		{
+			int witness = reconstruction_stack[begin];
+			model[variable(witness)] = witness > 0 ? 1 : 0;
+		}
+		end = begin;
+	}
+}
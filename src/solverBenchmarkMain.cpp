@@ -0,0 +1,470 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include "include/dpllSolver.h"
+#include "include/dimacsParser.h"
+#include "include/sudokuSolver.h"
+
+/**
+ * Tiempo mínimo que se mide cada benchmark, en segundos (se cambia con `--min-time`).
+ */
+#define DEFAULT_MIN_TIME 0.5
+
+/**
+ * Las instancias reales de `tests/`; el programa se ejecuta desde la raíz del proyecto.
+ */
+#define REAL_CNF_PATH "tests/dpll/uf250-1065/uf250-01.cnf"
+
+#define REAL_SUDOKU_PATH "tests/sudoku/cheese.txt"
+
+/**
+ * La fórmula sintética: 3-SAT al azar en el umbral de satisfacibilidad, lo bastante grande para
+ * que las listas de vigilancia no quepan en la caché.
+ */
+#define SYNTHETIC_VARIABLES 100000
+
+#define SYNTHETIC_CLAUSES 426000
+
+/**
+ * @brief El estado de una corrida de un benchmark, al estilo de Google Benchmark.
+ *
+ * El benchmark prepara lo que necesita, repite su operación mientras `keep_running` devuelva
+ * `true` y con `pause_timing`/`resume_timing` deja fuera de la medición lo que no quiere medir.
+ * Pausar cuesta dos lecturas del reloj, así que solo conviene en operaciones de más de un
+ * microsegundo o en pasos poco frecuentes.
+ *
+ * @note Ejemplo de uso:
+ *       while (state.keep_running())
+ *       {
+ *           operacion();
+ *           state.add_items(1);
+ *       }
+ */
+class BenchmarkState
+{
+public:
+	BenchmarkState(uint64_t iterations) : iterations(iterations), remaining(iterations)
+	{
+	}
+
+	bool keep_running()
+	{
+		if (remaining == iterations)
+		{
+			resume_timing();
+		}
+		if (remaining == 0)
+		{
+			pause_timing();
+			return false;
+		}
+		--remaining;
+		return true;
+	}
+
+	void pause_timing()
+	{
+		elapsed += std::chrono::steady_clock::now() - start;
+	}
+
+	void resume_timing()
+	{
+		start = std::chrono::steady_clock::now();
+	}
+
+	void add_items(uint64_t count)
+	{
+		items += count;
+	}
+
+	uint64_t get_items() const
+	{
+		return items;
+	}
+
+	double seconds() const
+	{
+		return std::chrono::duration<double>(elapsed).count();
+	}
+
+private:
+	uint64_t iterations;
+
+	uint64_t remaining;
+
+	uint64_t items = 0;
+
+	std::chrono::steady_clock::time_point start;
+
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::duration::zero();
+};
+
+/**
+ * @brief Un benchmark: su nombre, qué cuenta como ítem y la función que lo corre.
+ */
+struct Benchmark
+{
+	std::string name;
+
+	std::string items_name;
+
+	std::function<void(BenchmarkState &)> run;
+};
+
+/**
+ * @brief Llama a las funciones internas de `Solver` (es su `friend`) para medirlas por separado.
+ */
+class SolverBenchmark
+{
+public:
+	/**
+	 * @brief Deja un solver con la fórmula ya agregada listo para llamar a sus funciones internas:
+	 *        hace la preparación de `solve` y propaga las cláusulas unitarias, sin decidir nada.
+	 */
+	static void prepare(Solver &solver)
+	{
+		std::atomic<bool> stop(true);
+		solver.set_stop_flag(&stop);
+		solver.solve();
+		solver.set_stop_flag(nullptr);
+	}
+
+	/**
+	 * @brief Mide `propagate_conflicts` después de cada decisión. Los ítems son los literales implicados.
+	 *
+	 * Las decisiones salen de `decisions` (saltando las variables que ya tienen valor); después de
+	 * un conflicto o de asignar todas las variables se vuelve al nivel 0 sin medirlo.
+	 */
+	static void propagate(BenchmarkState &state, Solver &solver, const std::vector<int> &decisions)
+	{
+		size_t next = 0;
+		while (state.keep_running())
+		{
+			state.pause_timing();
+			int literal = next_unassigned(solver, decisions, next);
+			if (literal == 0)
+			{
+				solver.backjump(0);
+				literal = next_unassigned(solver, decisions, next);
+			}
+			solver.decide(literal);
+			size_t trail_before = solver.model_stack.size();
+			state.resume_timing();
+
+			bool conflict = solver.propagate_conflicts();
+
+			state.pause_timing();
+			state.add_items(solver.model_stack.size() - trail_before);
+			if (conflict)
+			{
+				solver.backjump(0);
+			}
+			state.resume_timing();
+		}
+	}
+
+	/**
+	 * @brief Mide `get_next_decision_literal` junto con la asignación de la decisión (sin propagar).
+	 *        Los ítems son las decisiones.
+	 *
+	 * Antes se les da a las variables actividades al azar, para que el orden del heap no sea el trivial.
+	 */
+	static void decide(BenchmarkState &state, Solver &solver, const std::vector<int> &decisions)
+	{
+		std::mt19937_64 random(3);
+		std::uniform_int_distribution<size_t> index(0, decisions.size() - 1);
+		for (size_t i = 0; i < 4 * decisions.size(); ++i)
+		{
+			solver.update_activity_literal(decisions[index(random)]);
+		}
+
+		while (state.keep_running())
+		{
+			int literal = solver.get_next_decision_literal();
+			if (literal == 0)
+			{
+				state.pause_timing();
+				solver.backjump(0);
+				state.resume_timing();
+				continue;
+			}
+			solver.decide(literal);
+			state.add_items(1);
+		}
+	}
+
+	/**
+	 * @brief Mide `backjump` hasta el nivel 0 desde una asignación hecha con decisiones y
+	 *        propagaciones hasta el primer conflicto (o hasta asignar todo). Los ítems son los
+	 *        literales desasignados.
+	 */
+	static void backjump(BenchmarkState &state, Solver &solver, const std::vector<int> &decisions)
+	{
+		size_t next = 0;
+		while (state.keep_running())
+		{
+			state.pause_timing();
+			int literal;
+			while ((literal = next_unassigned(solver, decisions, next)) != 0)
+			{
+				solver.decide(literal);
+				if (solver.propagate_conflicts())
+				{
+					break;
+				}
+			}
+			size_t trail = solver.model_stack.size() - solver.decision_level;
+			state.resume_timing();
+
+			solver.backjump(0);
+
+			state.add_items(trail);
+		}
+	}
+
+private:
+	/**
+	 * @brief Devuelve el siguiente literal de `decisions` cuya variable no tiene valor, o 0 si todas tienen.
+	 */
+	static int next_unassigned(const Solver &solver, const std::vector<int> &decisions, size_t &next)
+	{
+		if (solver.model_stack.size() - solver.decision_level >= solver.num_variables)
+		{
+			return 0;
+		}
+		while (true)
+		{
+			int literal = decisions[next];
+			next = (next + 1) % decisions.size();
+			if (solver.get_literal_value(literal) == -1)
+			{
+				return literal;
+			}
+		}
+	}
+};
+
+/**
+ * @brief Genera una fórmula 3-SAT al azar (sin variables repetidas en una cláusula).
+ */
+static CnfFormula random_3sat(uint num_variables, uint num_clauses, uint64_t seed)
+{
+	std::mt19937_64 random(seed);
+	std::uniform_int_distribution<int> variable(1, num_variables);
+	CnfFormula formula;
+	formula.num_variables = num_variables;
+	for (uint i = 0; i < num_clauses; ++i)
+	{
+		int a = variable(random);
+		int b;
+		int c;
+		do
+		{
+			b = variable(random);
+		} while (b == a);
+		do
+		{
+			c = variable(random);
+		} while (c == a or c == b);
+		formula.add_clause({random() % 2 ? a : -a, random() % 2 ? b : -b, random() % 2 ? c : -c});
+	}
+	return formula;
+}
+
+/**
+ * @brief Devuelve un literal de cada variable `1..num_variables`, en orden y con signo al azar.
+ */
+static std::vector<int> random_literals(uint num_variables, uint64_t seed)
+{
+	std::mt19937_64 random(seed);
+	std::vector<int> literals;
+	for (uint var = 1; var <= num_variables; ++var)
+	{
+		literals.push_back(random() % 2 ? int(var) : -int(var));
+	}
+	std::shuffle(literals.begin(), literals.end(), random);
+	return literals;
+}
+
+static const CnfFormula &real_formula()
+{
+	static CnfFormula formula;
+	if (formula.num_clauses == 0)
+	{
+		parse_DIMACS_file(REAL_CNF_PATH, formula);
+	}
+	return formula;
+}
+
+static const CnfFormula &synthetic_formula()
+{
+	static const CnfFormula formula = random_3sat(SYNTHETIC_VARIABLES, SYNTHETIC_CLAUSES, 1);
+	return formula;
+}
+
+static const CnfFormula &sudoku_formula()
+{
+	static CnfFormula formula;
+	if (formula.num_clauses == 0)
+	{
+		std::vector<int> variables;
+		encode_sudoku_with_options(read_sudoku(REAL_SUDOKU_PATH), SudokuOptions(), formula, variables);
+	}
+	return formula;
+}
+
+/**
+ * @brief Crea un benchmark de una función interna del solver sobre una fórmula.
+ */
+static Benchmark solver_benchmark(const std::string &name, const std::string &items_name,
+								  const CnfFormula &(*formula)(),
+								  void (*kernel)(BenchmarkState &, Solver &, const std::vector<int> &))
+{
+	return {name, items_name, [=](BenchmarkState &state)
+			{
+				Solver solver;
+				solver.add_formula(formula());
+				SolverBenchmark::prepare(solver);
+				kernel(state, solver, random_literals(solver.get_num_variables(), 2));
+			}};
+}
+
+/**
+ * @brief Crea un benchmark de `parse_DIMACS_input` sobre un archivo. Los ítems son los bytes leídos.
+ */
+static Benchmark parse_benchmark(const std::string &name, const std::string &path)
+{
+	return {name, "bytes", [=](BenchmarkState &state)
+			{
+				while (state.keep_running())
+				{
+					state.pause_timing();
+					Solver solver;
+					state.resume_timing();
+					state.add_items(parse_DIMACS_input(path, solver).bytes);
+				}
+			}};
+}
+
+/**
+ * @brief Crea un benchmark de `parse_sudoku_to_DIMACS`. Los ítems son los bytes del texto generado.
+ */
+static Benchmark sudoku_benchmark(const std::string &name, const std::string &path, bool compact)
+{
+	return {name, "bytes", [=](BenchmarkState &state)
+			{
+				SudokuOptions options;
+				options.compact = compact;
+				while (state.keep_running())
+				{
+					state.add_items(parse_sudoku_to_DIMACS(path, options).size());
+				}
+			}};
+}
+
+/**
+ * @brief Corre un benchmark con cada vez más iteraciones, hasta que la parte medida dure al menos
+ *        `min_time` segundos, e imprime el tiempo por iteración y los ítems por segundo.
+ */
+static void run_benchmark(const Benchmark &benchmark, double min_time)
+{
+	uint64_t iterations = 1;
+	while (true)
+	{
+		BenchmarkState state(iterations);
+		benchmark.run(state);
+		double seconds = state.seconds();
+
+		if (seconds >= min_time or iterations >= 1000000000)
+		{
+			std::printf("%-44s %12llu %14.1f ns/op %16.0f %s/s\n", benchmark.name.c_str(),
+						(unsigned long long)iterations, seconds * 1e9 / iterations, state.get_items() / seconds,
+						benchmark.items_name.c_str());
+			return;
+		}
+
+		// Como Google Benchmark: se estima cuántas iteraciones hacen falta, con un margen del 40%
+		double factor = seconds > 0 ? 1.4 * min_time / seconds : 100;
+		iterations = uint64_t(iterations * std::min(100.0, std::max(2.0, factor)));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	std::string filter;
+	double min_time = DEFAULT_MIN_TIME;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--filter" && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else if (arg == "--min-time" && i + 1 < argc)
+		{
+			min_time = std::atof(argv[++i]);
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--filter text] [--min-time seconds]" << std::endl;
+			return 1;
+		}
+	}
+
+	// Un sudoku 16x16 vacio y la formula sintetica en un archivo, para los parsers
+	std::filesystem::path temp_folder = std::filesystem::temp_directory_path();
+	std::string synthetic_cnf_path = (temp_folder / "solverBenchmark_synthetic.cnf").string();
+	std::string synthetic_sudoku_path = (temp_folder / "solverBenchmark_sudoku16.txt").string();
+
+	std::vector<Benchmark> benchmarks = {
+		solver_benchmark("propagate_conflicts/uf250", "literals", real_formula, SolverBenchmark::propagate),
+		solver_benchmark("propagate_conflicts/random_3sat_100k", "literals", synthetic_formula, SolverBenchmark::propagate),
+		solver_benchmark("propagate_conflicts/sudoku_cheese", "literals", sudoku_formula, SolverBenchmark::propagate),
+		solver_benchmark("get_next_decision_literal/uf250", "decisions", real_formula, SolverBenchmark::decide),
+		solver_benchmark("get_next_decision_literal/random_3sat_100k", "decisions", synthetic_formula, SolverBenchmark::decide),
+		solver_benchmark("backjump/uf250", "literals", real_formula, SolverBenchmark::backjump),
+		solver_benchmark("backjump/random_3sat_100k", "literals", synthetic_formula, SolverBenchmark::backjump),
+		parse_benchmark("parse_DIMACS_input/uf250", REAL_CNF_PATH),
+		parse_benchmark("parse_DIMACS_input/random_3sat_100k", synthetic_cnf_path),
+		sudoku_benchmark("parse_sudoku_to_DIMACS/cheese", REAL_SUDOKU_PATH, false),
+		sudoku_benchmark("parse_sudoku_to_DIMACS/cheese_compact", REAL_SUDOKU_PATH, true),
+		sudoku_benchmark("parse_sudoku_to_DIMACS/empty_16x16", synthetic_sudoku_path, false),
+	};
+
+	try
+	{
+		std::ofstream synthetic_cnf(synthetic_cnf_path);
+		write_DIMACS(synthetic_formula(), synthetic_cnf);
+		synthetic_cnf.close();
+		std::ofstream synthetic_sudoku(synthetic_sudoku_path);
+		synthetic_sudoku << std::string(256, '.') << std::endl;
+		synthetic_sudoku.close();
+
+		std::printf("%-44s %12s %20s %18s\n", "Benchmark", "Iterations", "Time", "Throughput");
+		for (const Benchmark &benchmark : benchmarks)
+		{
+			if (benchmark.name.find(filter) != std::string::npos)
+			{
+				run_benchmark(benchmark, min_time);
+			}
+		}
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		std::filesystem::remove(synthetic_cnf_path);
+		std::filesystem::remove(synthetic_sudoku_path);
+		return 1;
+	}
+
+	std::filesystem::remove(synthetic_cnf_path);
+	std::filesystem::remove(synthetic_sudoku_path);
+	return 0;
+}
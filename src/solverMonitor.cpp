@@ -0,0 +1,168 @@
+#include "solverMonitor.h"
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+std::atomic<bool> SolverMonitor::interrupt_requested(false);
+
+std::atomic<bool> SolverMonitor::dump_requested(false);
+
+SolverMonitor::SolverMonitor(std::ostream &out, double progress_interval)
+	: out(out), progress_interval(progress_interval), start_time(std::chrono::steady_clock::now())
+{
+}
+
+void SolverMonitor::handle_signal(int signal)
+{
+	// Solo se marcan banderas: escribir o pedir memoria aqui no es seguro
+	if (signal == SIGINT)
+	{
+		interrupt_requested.store(true, std::memory_order_relaxed);
+	}
+	else
+	{
+		dump_requested.store(true, std::memory_order_relaxed);
+	}
+}
+
+void SolverMonitor::install_signal_handlers()
+{
+	struct sigaction action = {};
+	action.sa_handler = handle_signal;
+	sigemptyset(&action.sa_mask);
+
+	// Con SA_RESETHAND el segundo SIGINT ya no pasa por aqui y termina el proceso
+	action.sa_flags = SA_RESTART | SA_RESETHAND;
+	sigaction(SIGINT, &action, nullptr);
+
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1, &action, nullptr);
+}
+
+void SolverMonitor::attach(Solver &solver)
+{
+	solver.set_monitor(this);
+	solver.set_stop_flag(&interrupt_requested);
+}
+
+double SolverMonitor::elapsed_seconds() const
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+	return elapsed.count();
+}
+
+void SolverMonitor::check(const Solver &solver)
+{
+	if (dump_requested.exchange(false, std::memory_order_relaxed))
+	{
+		print_dump(solver);
+	}
+
+	if (progress_interval > 0 and elapsed_seconds() - last_progress_seconds >= progress_interval)
+	{
+		print_progress(solver);
+	}
+}
+
+void SolverMonitor::print_progress(const Solver &solver)
+{
+	const SolverStatistics &statistics = solver.get_statistics();
+	double seconds = elapsed_seconds();
+	double interval = std::max(seconds - last_progress_seconds, 1e-9);
+
+	// Se arma aparte para no cambiar el formato de los numeros de `out`
+	std::ostringstream line;
+	line << std::fixed << std::setprecision(1) << "Progress: " << seconds << " s, " << statistics.conflicts
+		 << " conflicts (" << (statistics.conflicts - last_conflicts) / interval << "/s), " << statistics.propagations
+		 << " propagations (" << (statistics.propagations - last_propagations) / interval << "/s), depth "
+		 << solver.get_decision_level() << " (max " << statistics.max_decision_level << "), trail "
+		 << solver.get_trail_size() << "/" << solver.get_num_variables() << ", "
+		 << solver.get_num_learned_clauses() << " learned clauses, " << current_memory_bytes() / 1048576.0 << " MB";
+	out << line.str() << std::endl;
+
+	last_progress_seconds = seconds;
+	last_conflicts = statistics.conflicts;
+	last_propagations = statistics.propagations;
+}
+
+void SolverMonitor::print_dump(const Solver &solver)
+{
+	SolverStatistics statistics = solver.get_statistics();
+	statistics.parse = parse_statistics;
+	double seconds = std::max(elapsed_seconds(), 1e-9);
+
+	out << "Statistics after " << seconds << " seconds:" << std::endl;
+	print_solver_statistics(statistics, out);
+	out << "Rates: " << statistics.conflicts / seconds << " conflicts/s, " << statistics.propagations / seconds
+		<< " propagations/s, " << statistics.decisions / seconds << " decisions/s" << std::endl;
+	out << "Search: decision level " << solver.get_decision_level() << ", " << solver.get_trail_size() << " of "
+		<< solver.get_num_variables() << " variables assigned, " << solver.get_num_learned_clauses()
+		<< " learned clauses alive" << std::endl;
+	out << "Memory: " << current_memory_bytes() / 1048576.0 << " MB (peak " << peak_memory_bytes() / 1048576.0
+		<< " MB)" << std::endl;
+}
+
+uint64_t current_memory_bytes()
+{
+	// La segunda columna de /proc/self/statm es la memoria residente, en paginas
+	std::ifstream statm("/proc/self/statm");
+	uint64_t size = 0;
+	uint64_t resident = 0;
+	if (not(statm >> size >> resident))
+	{
+		return 0;
+	}
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+uint64_t peak_memory_bytes()
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+	// En Linux ru_maxrss esta en kilobytes
+	return uint64_t(usage.ru_maxrss) * 1024;
+}
+
+void write_solver_statistics_json(const SolverStatistics &statistics, const std::string &status, double seconds,
+								  std::ostream &out)
+{
+	double rate_seconds = std::max(seconds, 1e-9);
+	const PreprocessStatistics &preprocess = statistics.preprocess;
+
+	out << "{\"status\":\"" << status << "\""
+		<< ",\"stop_reason\":\"" << statistics.stop_reason << "\""
+		<< ",\"seconds\":" << seconds
+		<< ",\"decisions\":" << statistics.decisions
+		<< ",\"propagations\":" << statistics.propagations
+		<< ",\"conflicts\":" << statistics.conflicts
+		<< ",\"conflicts_per_second\":" << statistics.conflicts / rate_seconds
+		<< ",\"propagations_per_second\":" << statistics.propagations / rate_seconds
+		<< ",\"max_decision_level\":" << statistics.max_decision_level
+		<< ",\"average_conflict_level\":"
+		<< (statistics.conflicts > 0 ? double(statistics.conflict_level_sum) / statistics.conflicts : 0.0)
+		<< ",\"learned_clauses\":" << statistics.learned_clauses
+		<< ",\"deleted_clauses\":" << statistics.deleted_clauses
+		<< ",\"reductions\":" << statistics.reductions
+		<< ",\"arena_compactions\":" << statistics.arena_compactions
+		<< ",\"restarts\":" << statistics.restarts
+		<< ",\"exported_clauses\":" << statistics.exported_clauses
+		<< ",\"imported_clauses\":" << statistics.imported_clauses
+		<< ",\"propagation_allocations\":" << statistics.propagation_allocations
+		<< ",\"parse_bytes\":" << statistics.parse.bytes
+		<< ",\"parse_seconds\":" << statistics.parse.seconds
+		<< ",\"preprocess\":{\"clauses_before\":" << preprocess.clauses_before
+		<< ",\"clauses_after\":" << preprocess.clauses_after
+		<< ",\"fixed_variables\":" << preprocess.fixed_variables
+		<< ",\"eliminated_variables\":" << preprocess.eliminated_variables
+		<< ",\"subsumed_clauses\":" << preprocess.subsumed_clauses
+		<< ",\"strengthened_clauses\":" << preprocess.strengthened_clauses
+		<< ",\"removed_clauses\":" << preprocess.removed_clauses
+		<< ",\"seconds\":" << preprocess.seconds << "}"
+		<< ",\"peak_memory_bytes\":" << peak_memory_bytes() << "}" << std::endl;
+}
@@ -1,32 +1,162 @@
 #include "sudokuSolver.h"
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 
 /*
- * El codigo utilizado para pasar de un sudoku a un archivo DIMACS fue tomado de: 
+ * El codigo utilizado para pasar de un sudoku a un archivo DIMACS fue tomado de:
  * https://users.aalto.fi/~tjunttil/2020-DP-AUT/notes-sat/solving.html
 */
 
-int var(int r, int c, int v)
+/**
+ * @brief Devuelve la raíz cuadrada entera de `x`, o -1 si `x` no es un cuadrado perfecto.
+ */
+static int exact_sqrt(int x)
 {
-	if (!(1 <= r && r <= N && 1 <= c && c <= N && 1 <= v && v <= N))
+	int root = 0;
+	while ((root + 1) * (root + 1) <= x)
 	{
-		throw std::out_of_range("Entrada invalida:\nCondición '1 <= r <= N, 1 <= c <= N, 1 <= v <= N' not met. "
-								"Values are: r = " +
-								std::to_string(r) +
-								", c = " + std::to_string(c) +
-								", v = " + std::to_string(v) +
-								", N = " + std::to_string(N));
+		root++;
 	}
-	return (r - 1) * N * N + (c - 1) * N + (v - 1) + 1;
+	return root * root == x ? root : -1;
 }
 
-std::string parse_sudoku_to_DIMACS(std::string sudoku_path)
+/**
+ * @brief Devuelve el valor de una celda escrita con un caracter, o 0 si está vacía
+ *        (`.`, `0` o cualquier caracter que no sea `1`-`9`, `A`-`Z` o `a`-`z`).
+ */
+static int cell_char_value(char cell)
+{
+	if ('1' <= cell && cell <= '9')
+	{
+		return cell - '0';
+	}
+	if ('A' <= cell && cell <= 'Z')
+	{
+		return cell - 'A' + 10;
+	}
+	if ('a' <= cell && cell <= 'z')
+	{
+		return cell - 'a' + 10;
+	}
+	return 0;
+}
+
+/**
+ * @brief Separa una línea en palabras separadas por espacios.
+ */
+static std::vector<std::string> split_tokens(const std::string &line)
+{
+	std::istringstream stream(line);
+	std::vector<std::string> tokens;
+	std::string token;
+	while (stream >> token)
+	{
+		tokens.push_back(token);
+	}
+	return tokens;
+}
+
+/**
+ * @brief Convierte una celda escrita como número (o `.`) en su valor.
+ */
+static int cell_token_value(const std::string &token)
+{
+	if (token == ".")
+	{
+		return 0;
+	}
+	try
+	{
+		size_t parsed = 0;
+		int value = std::stoi(token, &parsed);
+		if (parsed == token.size() && value >= 0)
+		{
+			return value;
+		}
+	}
+	catch (const std::exception &e)
+	{
+	}
+	throw std::runtime_error("Celda invalida: " + token);
+}
+
+/**
+ * @brief Convierte las celdas leídas (en el formato que sea) en un sudoku, comprobando su tamaño.
+ */
+static Sudoku make_sudoku(const std::vector<int> &values)
+{
+	int size = exact_sqrt(values.size());
+	int box_size = size > 0 ? exact_sqrt(size) : -1;
+	if (box_size <= 0)
+	{
+		throw std::runtime_error("La cantidad de celdas (" + std::to_string(values.size()) +
+								 ") no corresponde a un sudoku de N x N con N = D * D.");
+	}
+
+	Sudoku sudoku(box_size);
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		if (values[i] > sudoku.size)
+		{
+			throw std::runtime_error("El valor " + std::to_string(values[i]) + " es mayor que N = " +
+									 std::to_string(sudoku.size) + ".");
+		}
+		sudoku.cells[i] = values[i];
+	}
+	return sudoku;
+}
+
+/**
+ * @brief Agrega a `values` las celdas de un texto, en el formato de un caracter por celda o en el
+ *        de números separados por espacios.
+ */
+static void append_cells(const std::string &text, std::vector<int> &values)
+{
+	if (text.find_first_of(" \t") == std::string::npos)
+	{
+		for (char cell : text)
+		{
+			values.push_back(cell_char_value(cell));
+		}
+	}
+	else
+	{
+		for (const std::string &token : split_tokens(text))
+		{
+			values.push_back(cell_token_value(token));
+		}
+	}
+}
+
+/**
+ * @brief Quita los espacios y el retorno de carro que haya al principio o al final de una línea.
+ */
+static std::string trim(const std::string &line)
+{
+	size_t begin = line.find_first_not_of(" \t\r");
+	if (begin == std::string::npos)
+	{
+		return "";
+	}
+	size_t end = line.find_last_not_of(" \t\r");
+	return line.substr(begin, end - begin + 1);
+}
+
+Sudoku parse_sudoku_line(const std::string &line)
+{
+	std::vector<int> values;
+	append_cells(trim(line), values);
+	return make_sudoku(values);
+}
+
+Sudoku read_sudoku(std::string sudoku_path)
 {
 	std::ifstream file(sudoku_path);
 	std::vector<std::string> clues = {};
-	std::vector<std::vector<int>> clauses = {};
-
-	std::map<char, int> digits = {
-		{'0', 0}, {'1', 1}, {'2', 2}, {'3', 3}, {'4', 4}, {'5', 5}, {'6', 6}, {'7', 7}, {'8', 8}, {'9', 9}};
 
 	if (!file.is_open())
 	{
@@ -36,25 +166,138 @@ std::string parse_sudoku_to_DIMACS(std::string sudoku_path)
 	std::string line;
 	while (std::getline(file, line))
 	{
-		clues.push_back(line);
+		line = trim(line);
+		if (!line.empty())
+		{
+			clues.push_back(line);
+		}
 	}
 	file.close();
 
-	// Si el sudoku tiene una sola fila, lo convertimos a 9 filas
-	if (clues.size() == 1 && clues[0].size() == 81)
-    {
-        std::string single_line = clues[0];
-        clues.clear();
-        for (int i = 0; i < 81; i += 9)
-        {
-            clues.push_back(single_line.substr(i, 9));
-        }
-    }
+	// Si el sudoku tiene una sola fila, tiene todas las celdas
+	if (clues.size() == 1)
+	{
+		return parse_sudoku_line(clues[0]);
+	}
+
+	std::vector<int> values;
+	for (const std::string &row : clues)
+	{
+		size_t before = values.size();
+		append_cells(row, values);
+		if (values.size() - before != clues.size())
+		{
+			throw std::runtime_error("El número de filas en el archivo no coincide con el número de celdas de cada fila.");
+		}
+	}
+	return make_sudoku(values);
+}
+
+std::string format_sudoku(const Sudoku &sudoku)
+{
+	std::string text = "";
+	for (size_t i = 0; i < sudoku.cells.size(); i++)
+	{
+		int value = sudoku.cells[i];
+		if (sudoku.size <= SUDOKU_MAX_SINGLE_CHAR_SIZE)
+		{
+			text += value == 0 ? '.' : value <= 9 ? static_cast<char>('0' + value) : static_cast<char>('A' + value - 10);
+		}
+		else
+		{
+			text += (i == 0 ? "" : " ") + std::to_string(value);
+		}
+	}
+	return text;
+}
+
+/**
+ * @brief Llama a `function` con el tamaño de subcuadrícula como constante de compilación si es
+ *        uno de los comunes (2, 3, 4 o 5), o con 0 si hay que usar el tamaño en tiempo de ejecución.
+ *
+ * Así las codificaciones de los tamaños comunes se compilan con N fijo (los ciclos y los cálculos
+ * de índices se optimizan), y cualquier otro tamaño usa la misma implementación con N variable.
+ */
+template <typename Function>
+static void dispatch_box_size(int box_size, Function function)
+{
+	switch (box_size)
+	{
+	case 2:
+		function(std::integral_constant<int, 2>());
+		break;
+	case 3:
+		function(std::integral_constant<int, 3>());
+		break;
+	case 4:
+		function(std::integral_constant<int, 4>());
+		break;
+	case 5:
+		function(std::integral_constant<int, 5>());
+		break;
+	default:
+		function(std::integral_constant<int, 0>());
+		break;
+	}
+}
 
-	if (clues.size() != N)
+/**
+ * @brief Devuelve la celda (índice `(r - 1) * N + (c - 1)`) número `k` de la unidad `unit`.
+ *
+ * Las unidades 0 a N-1 son las filas, N a 2N-1 las columnas y 2N a 3N-1 las subcuadrículas.
+ */
+static inline int unit_cell(int D, int N, int unit, int k)
+{
+	if (unit < N)
 	{
-		throw std::runtime_error("El número de filas en el archivo no coincide con el tamaño esperado N.");
+		return unit * N + k;
 	}
+	if (unit < 2 * N)
+	{
+		return k * N + (unit - N);
+	}
+	int box = unit - 2 * N;
+	return ((box / D) * D + k / D) * N + (box % D) * D + k % D;
+}
+
+/**
+ * @brief Agrega las cláusulas binarias que prohíben que dos de los literales sean verdaderos a la vez.
+ */
+static void add_at_most_one(const std::vector<int> &literals, CnfFormula &formula)
+{
+	for (size_t i = 0; i < literals.size(); i++)
+	{
+		for (size_t j = i + 1; j < literals.size(); j++)
+		{
+			formula.add_literal(-literals[i]);
+			formula.add_literal(-literals[j]);
+			formula.end_clause();
+		}
+	}
+}
+
+/**
+ * @brief Agrega una cláusula con todos los literales de `literals`.
+ */
+static void add_at_least_one(const std::vector<int> &literals, CnfFormula &formula)
+{
+	for (int literal : literals)
+	{
+		formula.add_literal(literal);
+	}
+	formula.end_clause();
+}
+
+template <int STATIC_BOX_SIZE>
+static void encode_sudoku_rules_impl(int box_size, CnfFormula &formula, bool redundant)
+{
+	const int D = STATIC_BOX_SIZE != 0 ? STATIC_BOX_SIZE : box_size;
+	const int N = D * D;
+	auto var = [N](int r, int c, int v) { return (r - 1) * N * N + (c - 1) * N + v; };
+
+	// Cada clausula de N literales ocupa N + 1 enteros (con el 0) y cada binaria ocupa 3
+	size_t binary_clauses = static_cast<size_t>(N) * N * N * (N - 1) / 2 * (redundant ? 4 : 1);
+	formula.literals.reserve(formula.literals.size() + 4 * static_cast<size_t>(N) * N * (N + 1) + 3 * binary_clauses);
 
 	std::vector<int> new_clause;
 	for (int r = 1; r <= N; r++)
@@ -65,114 +308,263 @@ std::string parse_sudoku_to_DIMACS(std::string sudoku_path)
 			new_clause = {};
 			for (int v = 1; v <= N; v++)
 			{
-				new_clause.push_back({var(r, c, v)});
+				new_clause.push_back(var(r, c, v));
 			}
-			clauses.push_back(new_clause);
+			add_at_least_one(new_clause, formula);
 
 			// No puede haber dos valores en la misma celda
-			for (int v = 1; v <= N; v++)
-			{
-				for (int w = v + 1; w <= N; w++)
-				{
-					clauses.push_back({-var(r, c, v), -var(r, c, w)});
-				}
-			}
+			add_at_most_one(new_clause, formula);
 		}
 	}
 
+	// Cada fila, columna y subcuadricula debe tener el valor v
 	for (int v = 1; v <= N; v++)
 	{
-
-		// Cada fila debe tener el valor v
-		for (int r = 1; r <= N; r++)
+		for (int unit = 0; unit < 3 * N; unit++)
 		{
 			new_clause = {};
-			for (int c = 1; c <= N; c++)
+			for (int k = 0; k < N; k++)
 			{
-				new_clause.push_back(var(r, c, v));
+				int cell = unit_cell(D, N, unit, k);
+				new_clause.push_back(var(cell / N + 1, cell % N + 1, v));
+			}
+			add_at_least_one(new_clause, formula);
+
+			if (redundant)
+			{
+				// Ningun valor se repite en una fila, columna o subcuadricula. Ya se deduce de las
+				// clausulas anteriores, pero asi la propagacion lo descubre sin tener que buscar
+				add_at_most_one(new_clause, formula);
 			}
-			clauses.push_back(new_clause);
 		}
+	}
 
-		// Cada columna debe tener el valor v
-		for (int c = 1; c <= N; c++)
+	// Aunque alguna variable no aparezca en las clausulas, el problema tiene N*N*N variables
+	formula.num_variables = std::max<unsigned int>(formula.num_variables, N * N * N);
+}
+
+void encode_sudoku_rules(int box_size, CnfFormula &formula, bool redundant)
+{
+	dispatch_box_size(box_size, [&](auto static_box_size)
+					  { encode_sudoku_rules_impl<decltype(static_box_size)::value>(box_size, formula, redundant); });
+}
+
+void encode_sudoku_clues(const Sudoku &sudoku, CnfFormula &formula)
+{
+	// las pistas se respetan
+	for (int r = 1; r <= sudoku.size; r++)
+	{
+		for (int c = 1; c <= sudoku.size; c++)
 		{
-			new_clause = {};
-			for (int r = 1; r <= N; r++)
+			int value = sudoku.cells[(r - 1) * sudoku.size + (c - 1)];
+			if (value != 0)
 			{
-				new_clause.push_back(var(r, c, v));
+				formula.add_clause({sudoku.var(r, c, value)});
 			}
-			clauses.push_back(new_clause);
 		}
+	}
+}
+
+void encode_sudoku(const Sudoku &sudoku, CnfFormula &formula, bool redundant)
+{
+	encode_sudoku_rules(sudoku.box_size, formula, redundant);
+	encode_sudoku_clues(sudoku, formula);
+}
 
-		// Cada subcuadricula debe tener el valor v
-		for (int sr = 0; sr < D; sr++)
+template <int STATIC_BOX_SIZE>
+static void encode_sudoku_compact_impl(const Sudoku &sudoku, bool redundant, CnfFormula &formula, std::vector<int> &variables)
+{
+	const int D = STATIC_BOX_SIZE != 0 ? STATIC_BOX_SIZE : sudoku.box_size;
+	const int N = D * D;
+	auto var = [N](int cell, int v) { return cell * N + v; };
+	auto units_of_cell = [N, D](int cell, int u) { return u == 0 ? cell / N : u == 1 ? N + cell % N : 2 * N + (cell / N / D) * D + (cell % N) / D; };
+
+	// placed[unit * (N + 1) + v] indica si una pista ya pone el valor v en la unidad
+	std::vector<char> placed(3 * N * (N + 1), false);
+	bool contradiction = false;
+	for (int cell = 0; cell < N * N; cell++)
+	{
+		int value = sudoku.cells[cell];
+		if (value != 0)
 		{
-			for (int sc = 0; sc < D; sc++)
+			for (int u = 0; u < 3; u++)
 			{
-				new_clause = {};
-				for (int rd = 1; rd <= D; rd++)
-				{
-					for (int cd = 1; cd <= D; cd++)
-					{
-						new_clause.push_back(var(sr * D + rd, sc * D + cd, v));
-					}
-				}
-				clauses.push_back(new_clause);
+				int unit = units_of_cell(cell, u);
+				contradiction = contradiction || placed[unit * (N + 1) + value];
+				placed[unit * (N + 1) + value] = true;
 			}
 		}
 	}
 
-	// las pistas se respetan
-	for (int r = 1; r <= N; r++)
+	// Solo tienen variable los valores que ninguna pista de la fila, columna o subcuadricula descarta
+	variables.assign(N * N * N + 1, 0);
+	int num_variables = 0;
+	for (int cell = 0; cell < N * N; cell++)
 	{
-		for (int c = 1; c <= N; c++)
+		if (sudoku.cells[cell] != 0)
+		{
+			continue;
+		}
+		for (int v = 1; v <= N; v++)
 		{
-			if (clues[r - 1][c - 1] != '.' && digits.find(clues[r - 1][c - 1]) != digits.end())
+			bool candidate = true;
+			for (int u = 0; u < 3; u++)
 			{
-				int value = digits[clues[r - 1][c - 1]];
-				clauses.push_back({var(r, c, value)});
+				candidate = candidate && !placed[units_of_cell(cell, u) * (N + 1) + v];
+			}
+			if (candidate)
+			{
+				variables[var(cell, v)] = ++num_variables;
+			}
+		}
+	}
+
+	if (contradiction)
+	{
+		// Dos pistas iguales en la misma unidad: el sudoku no tiene solucion
+		formula.add_clause({});
+		return;
+	}
+
+	std::vector<int> new_clause;
+	for (int cell = 0; cell < N * N; cell++)
+	{
+		if (sudoku.cells[cell] != 0)
+		{
+			continue;
+		}
 
-				// Posible mejora: agregar la negación de los demás valores
-				// for (int v = 1; v <= N; v++)
-				// {
-				// 	if (v != value)
-				// 	{
-				// 		clauses.push_back({-var(r, c, v)});
-				// 	}
-				// }
+		// La celda tiene uno de sus valores posibles y no tiene dos
+		new_clause = {};
+		for (int v = 1; v <= N; v++)
+		{
+			int variable = variables[var(cell, v)];
+			if (variable != 0)
+			{
+				new_clause.push_back(variable);
 			}
 		}
+		add_at_least_one(new_clause, formula);
+		add_at_most_one(new_clause, formula);
 	}
 
-	std::string dimacs = "p cnf " + std::to_string(N * N * N) + " " + std::to_string(clauses.size()) + "\n";
-	for (const auto &clause : clauses)
+	for (int unit = 0; unit < 3 * N; unit++)
 	{
-		for (int literal : clause)
+		for (int v = 1; v <= N; v++)
 		{
-			dimacs += std::to_string(literal) + " ";
+			if (placed[unit * (N + 1) + v])
+			{
+				continue;
+			}
+
+			// Algun valor posible de la unidad tiene el valor v
+			new_clause = {};
+			for (int k = 0; k < N; k++)
+			{
+				int variable = variables[var(unit_cell(D, N, unit, k), v)];
+				if (variable != 0)
+				{
+					new_clause.push_back(variable);
+				}
+			}
+			add_at_least_one(new_clause, formula);
+
+			if (redundant)
+			{
+				add_at_most_one(new_clause, formula);
+			}
 		}
-		dimacs += "0\n";
 	}
-	return dimacs;
+
+	formula.num_variables = num_variables;
 }
 
+void encode_sudoku_compact(const Sudoku &sudoku, bool redundant, CnfFormula &formula, std::vector<int> &variables)
+{
+	dispatch_box_size(sudoku.box_size, [&](auto static_box_size)
+					  { encode_sudoku_compact_impl<decltype(static_box_size)::value>(sudoku, redundant, formula, variables); });
+}
 
-std::string parse_model_to_solution(std::map<int, bool> model)
+void encode_sudoku_with_options(const Sudoku &sudoku, const SudokuOptions &options, CnfFormula &formula,
+							   std::vector<int> &variables)
 {
-	std::string solution = "";
-	for (int r = 1; r <= N; r++)
+	if (options.compact)
 	{
-		for (int c = 1; c <= N; c++)
+		encode_sudoku_compact(sudoku, options.redundant, formula, variables);
+	}
+	else
+	{
+		variables.clear();
+		encode_sudoku(sudoku, formula, options.redundant);
+	}
+}
+
+std::string parse_sudoku_to_DIMACS(std::string sudoku_path, const SudokuOptions &options)
+{
+	CnfFormula formula;
+	std::vector<int> variables;
+	encode_sudoku_with_options(read_sudoku(sudoku_path), options, formula, variables);
+
+	std::ostringstream dimacs;
+	write_DIMACS(formula, dimacs);
+	return dimacs.str();
+}
+
+
+std::string parse_model_to_solution(const Sudoku &sudoku, std::map<int, bool> model)
+{
+	Sudoku solution = sudoku;
+	for (int r = 1; r <= sudoku.size; r++)
+	{
+		for (int c = 1; c <= sudoku.size; c++)
 		{
 			int found_value = 0;
-			for (int v = 1; v <= N; v++)
+			for (int v = 1; v <= sudoku.size; v++)
+			{
+				if (model[sudoku.var(r, c, v)])
+				{
+					if (found_value != 0)
+					{
+						std::cerr << "Error: Se encontró más de un valor positivo en la celda ("
+								  << r << ", " << c << ")." << std::endl;
+						return "";
+					}
+					found_value = v;
+				}
+			}
+			if (found_value == 0)
+			{
+				std::cerr << "Error: No se encontró ningún valor positivo en la celda ("
+						  << r << ", " << c << ")." << std::endl;
+				return "";
+			}
+			solution.cells[(r - 1) * sudoku.size + (c - 1)] = found_value;
+		}
+	}
+	return format_sudoku(solution);
+}
+
+std::string parse_solver_to_solution(const Solver &solver, const Sudoku &sudoku, const std::vector<int> &variables)
+{
+	Sudoku solution = sudoku;
+	for (int r = 1; r <= sudoku.size; r++)
+	{
+		for (int c = 1; c <= sudoku.size; c++)
+		{
+			int found_value = sudoku.cells[(r - 1) * sudoku.size + (c - 1)];
+			if (found_value != 0)
+			{
+				continue;
+			}
+
+			for (int v = 1; v <= sudoku.size; v++)
 			{
-				if (model[var(r, c, v)])
+				int variable = variables.empty() ? sudoku.var(r, c, v) : variables[sudoku.var(r, c, v)];
+				if (variable != 0 && solver.get_literal_value(variable) == 1)
 				{
 					if (found_value != 0)
 					{
-						std::cerr << "Error: Se encontró más de un valor positivo en la celda (" 
+						std::cerr << "Error: Se encontró más de un valor positivo en la celda ("
 								  << r << ", " << c << ")." << std::endl;
 						return "";
 					}
@@ -181,12 +573,184 @@ std::string parse_model_to_solution(std::map<int, bool> model)
 			}
 			if (found_value == 0)
 			{
-				std::cerr << "Error: No se encontró ningún valor positivo en la celda (" 
+				std::cerr << "Error: No se encontró ningún valor positivo en la celda ("
 						  << r << ", " << c << ")." << std::endl;
 				return "";
 			}
-			solution += std::to_string(found_value);
+			solution.cells[(r - 1) * sudoku.size + (c - 1)] = found_value;
 		}
 	}
-	return solution;
-}
\ No newline at end of file
+	return format_sudoku(solution);
+}
+
+int solve_sudoku(const Sudoku &sudoku, std::string &solution, SolverStatistics *statistics, const SudokuOptions &options)
+{
+	CnfFormula formula;
+	std::vector<int> variables;
+	encode_sudoku_with_options(sudoku, options, formula, variables);
+
+	Solver solver(options.solver);
+	solver.add_formula(formula);
+
+	if (solver.solve())
+	{
+		solution = parse_solver_to_solution(solver, sudoku, variables);
+	}
+	if (statistics != nullptr)
+	{
+		*statistics = solver.get_statistics();
+	}
+	return solver.get_result();
+}
+
+Solver build_sudoku_base_solver(int box_size, bool redundant, const SolverOptions &solver_options)
+{
+	CnfFormula formula;
+	encode_sudoku_rules(box_size, formula, redundant);
+
+	Solver solver(solver_options);
+	solver.add_formula(formula);
+	return solver;
+}
+
+int solve_sudoku_with_base(const Solver &base_solver, const Sudoku &sudoku, std::string &solution)
+{
+	// Copiar el solver base es mas barato que volver a codificar y agregar las reglas
+	Solver solver = base_solver;
+	for (int i = 0; i < sudoku.size * sudoku.size; i++)
+	{
+		int value = sudoku.cells[i];
+		if (value != 0)
+		{
+			int literal = sudoku.var(i / sudoku.size + 1, i % sudoku.size + 1, value);
+			solver.add_clause(&literal, 1);
+		}
+	}
+
+	if (solver.solve())
+	{
+		solution = parse_solver_to_solution(solver, sudoku);
+	}
+	return solver.get_result();
+}
+
+double SudokuBatchSummary::latency_percentile(double percentile) const
+{
+	if (latencies.empty())
+	{
+		return 0.0;
+	}
+	size_t index = static_cast<size_t>(percentile / 100.0 * (latencies.size() - 1) + 0.5);
+	return latencies[index];
+}
+
+SudokuBatchSummary solve_sudoku_batch(std::istream &in, uint num_threads, const SudokuOptions &options, std::ostream &out)
+{
+	SudokuBatchSummary summary;
+
+	// Un solver base por cada tamaño de sudoku que aparezca en la entrada. Los nodos de un
+	// std::map no se mueven al insertar otros, asi que se pueden copiar fuera del mutex
+	std::map<int, Solver> base_solvers;
+	std::mutex base_solvers_mutex;
+
+	std::mutex in_mutex;
+	std::mutex out_mutex;
+	uint64_t line_number = 0;
+
+	auto start_time = std::chrono::steady_clock::now();
+
+	auto base_solver_for = [&](int box_size) -> const Solver &
+	{
+		std::lock_guard<std::mutex> lock(base_solvers_mutex);
+		auto it = base_solvers.find(box_size);
+		if (it == base_solvers.end())
+		{
+			it = base_solvers.emplace(box_size, build_sudoku_base_solver(box_size, options.redundant, options.solver)).first;
+		}
+		return it->second;
+	};
+
+	auto worker = [&]()
+	{
+		std::vector<std::pair<uint64_t, std::string>> puzzles;
+		std::vector<double> latencies;
+		std::ostringstream results;
+		uint64_t solved = 0;
+
+		while (true)
+		{
+			// Tomamos de la entrada un grupo de lineas, para no bloquear la entrada por cada sudoku
+			puzzles.clear();
+			{
+				std::lock_guard<std::mutex> lock(in_mutex);
+				std::string line;
+				while (puzzles.size() < SUDOKU_BATCH_CHUNK && std::getline(in, line))
+				{
+					++line_number;
+					line = trim(line);
+					if (!line.empty())
+					{
+						puzzles.push_back({line_number, line});
+					}
+				}
+			}
+			if (puzzles.empty())
+			{
+				break;
+			}
+
+			for (const auto &[number, line] : puzzles)
+			{
+				auto puzzle_start = std::chrono::steady_clock::now();
+				std::string solution;
+				std::string status;
+				try
+				{
+					Sudoku sudoku = parse_sudoku_line(line);
+					int result = options.compact ? solve_sudoku(sudoku, solution, nullptr, options)
+												 : solve_sudoku_with_base(base_solver_for(sudoku.box_size), sudoku, solution);
+					status = result_name(result);
+				}
+				catch (const std::exception &e)
+				{
+					// En lugar de la solucion va el motivo, para poder encontrar las lineas mal formadas
+					status = "ERROR";
+					solution = e.what();
+				}
+				std::chrono::duration<double> latency = std::chrono::steady_clock::now() - puzzle_start;
+				latencies.push_back(latency.count());
+				solved += status == "SAT";
+
+				results << number << "," << status << "," << solution << "\n";
+			}
+
+			std::lock_guard<std::mutex> lock(out_mutex);
+			out << results.str();
+			results.str("");
+		}
+
+		std::lock_guard<std::mutex> lock(out_mutex);
+		summary.latencies.insert(summary.latencies.end(), latencies.begin(), latencies.end());
+		summary.solved += solved;
+	};
+
+	num_threads = std::max(1u, num_threads);
+	std::vector<std::thread> workers;
+	for (uint t = 1; t < num_threads; ++t)
+	{
+		workers.emplace_back(worker);
+	}
+	// El hilo principal tambien trabaja
+	worker();
+	for (std::thread &thread : workers)
+	{
+		thread.join();
+	}
+	out.flush();
+
+	std::chrono::duration<double> elapsed_time = std::chrono::steady_clock::now() - start_time;
+	summary.seconds = elapsed_time.count();
+	summary.puzzles = summary.latencies.size();
+	std::sort(summary.latencies.begin(), summary.latencies.end());
+	return summary;
+}
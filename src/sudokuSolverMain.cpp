@@ -5,42 +5,134 @@
 #include <string>
 #include <stdexcept>
 #include <fstream>
+#include <chrono>
+#include <thread>
+
+void print_usage(const char* program) {
+    std::cerr << "Uso: " << program << " [--compact] [--redundant] [--write-cnf <archivo_cnf>] <archivo_sudoku>" << std::endl;
+    std::cerr << "     " << program << " [--compact] [--redundant] --batch <archivo_sudokus|-> [-j N]" << std::endl;
+    print_solver_options_usage(std::cerr);
+}
+
+/**
+ * @brief Modo por lotes: resuelve un sudoku por línea de `puzzles_path`.
+ *
+ * Las soluciones se escriben en la salida estándar y el resumen (sudokus por segundo y
+ * percentiles de la latencia) en la salida de errores.
+ */
+int batch_main(const std::string& puzzles_path, uint num_threads, const SudokuOptions& options) {
+    std::ifstream file;
+    if (puzzles_path != "-") {
+        file.open(puzzles_path);
+        if (!file) {
+            std::cerr << "Error: No se pudo abrir el archivo: " << puzzles_path << std::endl;
+            return 1;
+        }
+    }
+    std::istream &in = puzzles_path == "-" ? std::cin : file;
+
+    SudokuBatchSummary summary = solve_sudoku_batch(in, num_threads, options, std::cout);
+
+    std::cerr << "Puzzles: " << summary.puzzles << " (" << summary.solved << " solved) in "
+              << summary.seconds << " seconds, "
+              << (summary.seconds > 0 ? summary.puzzles / summary.seconds : 0) << " puzzles/s" << std::endl;
+    std::cerr << "Latency (ms): p50 " << summary.latency_percentile(50) * 1000
+              << ", p90 " << summary.latency_percentile(90) * 1000
+              << ", p99 " << summary.latency_percentile(99) * 1000
+              << ", max " << summary.latency_percentile(100) * 1000 << std::endl;
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Uso: " << argv[0] << " <archivo_sudoku>" << std::endl;
-        return 1;
+    SudokuOptions options;
+    // --write-cnf <archivo> guarda la codificacion en formato DIMACS (solo para depurar)
+    std::string cnf_path = "";
+    std::string batch_path = "";
+    std::string sudoku_path = "";
+    uint num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--compact") {
+            options.compact = true;
+        }
+        else if (arg == "--redundant") {
+            options.redundant = true;
+        }
+        else if (arg == "--write-cnf" && i + 1 < argc) {
+            cnf_path = argv[++i];
+        }
+        else if (arg == "--batch" && i + 1 < argc) {
+            batch_path = argv[++i];
+        }
+        else if (arg == "-j" && i + 1 < argc) {
+            num_threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (parse_solver_option(argc, argv, i, options.solver)) {
+            continue;
+        }
+        else if (sudoku_path == "" && arg[0] != '-') {
+            sudoku_path = arg;
+        }
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
     }
 
-    std::string sudoku_path = argv[1];
+    if (batch_path != "" && sudoku_path == "" && cnf_path == "") {
+        return batch_main(batch_path, num_threads, options);
+    }
+    if (batch_path != "" || sudoku_path == "") {
+        print_usage(argv[0]);
+        return 1;
+    }
 
     try {
-        // Procesar el archivo de Sudoku y generar el formato DIMACS
-        std::string dimacs = parse_sudoku_to_DIMACS(sudoku_path);
+        Sudoku sudoku = read_sudoku(sudoku_path);
+
+        // Start measuring time
+        auto start_time = std::chrono::high_resolution_clock::now();
 
-        // Generar un nombre de archivo único utilizando un identificador universal
-        std::string unique_filename = "sudoku_dimacs_" + std::to_string(std::hash<std::string>{}(sudoku_path)) + "_" + std::to_string(::time(nullptr)) + ".cnf";
+        // Las clausulas se le pasan al solver en memoria, sin escribir ni volver a leer un archivo
+        CnfFormula formula;
+        std::vector<int> variables;
+        encode_sudoku_with_options(sudoku, options, formula, variables);
 
-        // Guardar el contenido del formato DIMACS en el archivo
-        std::ofstream dimacs_file(unique_filename);
-        if (!dimacs_file) {
-            throw std::runtime_error("No se pudo crear el archivo DIMACS: " + unique_filename);
+        Solver solver(options.solver);
+        solver.add_formula(formula);
+        bool result = solver.solve();
+
+        std::string solution;
+        if (result) {
+            solution = parse_solver_to_solution(solver, sudoku, variables);
         }
-        dimacs_file << dimacs;
-        dimacs_file.close();
 
-        // Pasar la dirección del archivo al dpll_solver
-        auto [result, model] = dpll_solver(unique_filename);
+        // Stop measuring time
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed_time = end_time - start_time;
 
+        if (cnf_path != "") {
+            std::ofstream dimacs_file(cnf_path);
+            if (!dimacs_file) {
+                throw std::runtime_error("No se pudo crear el archivo DIMACS: " + cnf_path);
+            }
+            write_DIMACS(formula, dimacs_file);
+        }
 
         // Mostrar el resultado
         if (result) {
             std::cout << "SATISFIABLE" << std::endl;
-            std::string solution = parse_model_to_solution(model);
             std::cout << "Solución: " << solution << std::endl;
+        } else if (solver.was_stopped()) {
+            std::cout << "UNKNOWN (" << solver.get_statistics().stop_reason << ")" << std::endl;
         } else {
             std::cout << "UNSATISFIABLE" << std::endl;
         }
+        std::cout << "Size: " << sudoku.size << "x" << sudoku.size << std::endl;
+        std::cout << "Encoding: " << formula.num_variables << " variables, " << formula.num_clauses << " clauses" << std::endl;
+        std::cout << "Restarts: " << solver.get_statistics().restarts << std::endl;
+        std::cout << "Time: " << elapsed_time.count() << " seconds" << std::endl;
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -48,4 +140,4 @@ int main(int argc, char* argv[]) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,120 @@
+#include "variableHeap.h"
+
+void VariableHeap::grow(unsigned int max_var)
+{
+	if (max_var >= positions.size())
+	{
+		positions.resize(max_var + 1, -1);
+		activities.resize(max_var + 1, 0.0);
+	}
+}
+
+void VariableHeap::set_activity(unsigned int var, double activity)
+{
+	double old_activity = activities[var];
+	activities[var] = activity;
+
+	if (contains(var))
+	{
+		if (activity > old_activity)
+		{
+			sift_up(positions[var]);
+		}
+		else
+		{
+			sift_down(positions[var]);
+		}
+	}
+}
+
+void VariableHeap::scale_activities(double factor)
+{
+	for (double &activity : activities)
+	{
+		activity *= factor;
+	}
+}
+
+void VariableHeap::insert(unsigned int var)
+{
+	grow(var);
+
+	if (contains(var))
+	{
+		return;
+	}
+
+	positions[var] = heap.size();
+	heap.push_back(var);
+	sift_up(positions[var]);
+}
+
+unsigned int VariableHeap::pop_max()
+{
+	unsigned int max_var = heap[0];
+
+	// Movemos el ultimo elemento a la raiz y lo hundimos hasta su lugar
+	heap[0] = heap.back();
+	positions[heap[0]] = 0;
+	positions[max_var] = -1;
+	heap.pop_back();
+
+	if (heap.size() > 1)
+	{
+		sift_down(0);
+	}
+
+	return max_var;
+}
+
+void VariableHeap::clear()
+{
+	for (unsigned int var : heap)
+	{
+		positions[var] = -1;
+	}
+	heap.clear();
+}
+
+void VariableHeap::sift_up(unsigned int position)
+{
+	unsigned int var = heap[position];
+	while (position > 0)
+	{
+		unsigned int parent = (position - 1) / 2;
+		if (activities[heap[parent]] >= activities[var])
+		{
+			break;
+		}
+
+		heap[position] = heap[parent];
+		positions[heap[position]] = position;
+		position = parent;
+	}
+	heap[position] = var;
+	positions[var] = position;
+}
+
+void VariableHeap::sift_down(unsigned int position)
+{
+	unsigned int var = heap[position];
+	while (2 * position + 1 < heap.size())
+	{
+		unsigned int child = 2 * position + 1;
+		if (child + 1 < heap.size() && activities[heap[child + 1]] > activities[heap[child]])
+		{
+			++child;
+		}
+
+		if (activities[heap[child]] <= activities[var])
+		{
+			break;
+		}
+
+		heap[position] = heap[child];
+		positions[heap[position]] = position;
+		position = child;
+	}
+	heap[position] = var;
+	positions[var] = position;
+}